@@ -0,0 +1,308 @@
+﻿// concurrency_stress.cpp
+// Multi-threaded smoke/stress run over the engine's lock-free and concurrent
+// primitives. Every section checks that nothing is lost, duplicated or
+// reordered where ordering is promised; the process exits non-zero on the
+// first failure. Build it with -DALMOND_BUILD_STRESS=ON and run it under
+// -fsanitize=thread / -fsanitize=address to catch races and lifetime bugs.
+//
+//   concurrency_stress [rounds]   (default 4)
+
+#include "aworkstealingscheduler.hpp"   // jobs::ChaseLevDeque, jobs::scheduler()
+#include "aeventsystem.hpp"             // events::basic_mpsc_ring
+#include "ampmcboundedqueue.hpp"        // MPMCQueue
+#include "ataskgraphwithdot.hpp"        // taskgraph::TaskGraph
+#include "acommandqueue.hpp"            // core::CommandQueue
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using namespace almondnamespace;
+
+    int g_failures = 0;
+
+#define STRESS_CHECK(cond)                                                        \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::fprintf(stderr, "FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                         \
+        }                                                                         \
+    } while (0)
+
+    unsigned thread_count() {
+        return std::max(4u, std::thread::hardware_concurrency());
+    }
+
+    // ─── ChaseLevDeque: owner push/take racing thieves ─────────────────────
+    // every item must come out exactly once, across at least one grow()
+    void deque_stress() {
+        constexpr int Items = 200'000;
+        std::vector<int> payload(Items);
+        std::vector<std::atomic<int>> seen(Items);
+        jobs::ChaseLevDeque<int*> dq(64);   // small, so it grows under load
+
+        std::atomic<bool> ownerDone{ false };
+        std::vector<std::thread> thieves;
+        for (unsigned t = 0; t + 1 < thread_count(); ++t) {
+            thieves.emplace_back([&] {
+                for (;;) {
+                    if (int* p = dq.steal()) { seen[p - payload.data()].fetch_add(1, std::memory_order_relaxed); continue; }
+                    if (ownerDone.load(std::memory_order_acquire) && dq.size_approx() == 0) break;
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        for (int i = 0; i < Items; ++i) {
+            dq.push(&payload[i]);
+            if (i % 3 == 0)
+                if (int* p = dq.take()) seen[p - payload.data()].fetch_add(1, std::memory_order_relaxed);
+        }
+        while (int* p = dq.take()) seen[p - payload.data()].fetch_add(1, std::memory_order_relaxed);
+        ownerDone.store(true, std::memory_order_release);
+        for (auto& t : thieves) t.join();
+
+        int bad = 0;
+        for (auto& s : seen) bad += s.load() != 1;
+        STRESS_CHECK(bad == 0);
+    }
+
+    // ─── WorkStealingScheduler: nested fork/join, counters, exceptions ─────
+    std::uint64_t fib(int n) {
+        if (n < 2) return static_cast<std::uint64_t>(n);
+        std::uint64_t a = 0, b = 0;
+        jobs::scheduler().invoke([&] { a = fib(n - 1); }, [&] { b = fib(n - 2); });
+        return a + b;
+    }
+
+    void scheduler_stress() {
+        auto& s = jobs::scheduler();
+
+        STRESS_CHECK(fib(22) == 17711);
+
+        // nested parallel_for: workers waiting on their own children
+        std::atomic<std::uint64_t> sum{ 0 };
+        jobs::parallel_for(0, 64, 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+                jobs::parallel_for(0, 1000, 37, [&](std::size_t ib, std::size_t ie) {
+                    std::uint64_t local = 0;
+                    for (std::size_t k = ib; k < ie; ++k) local += k;
+                    sum.fetch_add(local, std::memory_order_relaxed);
+                });
+        });
+        STRESS_CHECK(sum.load() == 64ull * (999ull * 1000ull / 2));
+
+        // short-lived counters on the stack, submitted from outside the pool
+        for (int r = 0; r < 2000; ++r) {
+            jobs::Counter c;
+            std::atomic<int> hits{ 0 };
+            for (int i = 0; i < 8; ++i) s.submit([&] { hits.fetch_add(1, std::memory_order_relaxed); }, &c);
+            s.wait(c);
+            STRESS_CHECK(hits.load() == 8);
+        }
+
+        // a throwing job reaches the waiter, the pool keeps running
+        bool caught = false;
+        try {
+            jobs::parallel_for(0, 256, 16, [](std::size_t b, std::size_t) {
+                if (b == 128) throw std::runtime_error("stress");
+            });
+        }
+        catch (const std::runtime_error&) { caught = true; }
+        STRESS_CHECK(caught);
+        STRESS_CHECK(fib(12) == 144);
+    }
+
+    // ─── basic_mpsc_ring: producers vs one consumer ────────────────────────
+    struct Tagged { std::uint32_t producer = 0, seq = 0; };
+
+    template<events::OverflowPolicy P>
+    void mpsc_run(bool lossless) {
+        constexpr std::uint32_t PerProducer = 100'000;
+        const unsigned producers = thread_count() - 1;
+        auto ring = std::make_unique<events::basic_mpsc_ring<Tagged, 256, P>>();
+
+        std::atomic<unsigned> running{ producers };
+        std::vector<std::thread> ts;
+        for (unsigned p = 0; p < producers; ++p) {
+            ts.emplace_back([&, p] {
+                for (std::uint32_t i = 0; i < PerProducer; ++i) ring->enqueue(Tagged{ p, i });
+                running.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        std::vector<std::int64_t> last(producers, -1);
+        std::uint64_t got = 0;
+        bool ordered = true;
+        auto consume = [&](const Tagged& t) {
+            ordered &= static_cast<std::int64_t>(t.seq) > last[t.producer];
+            last[t.producer] = t.seq;
+            ++got;
+        };
+
+        Tagged t;
+        while (running.load(std::memory_order_acquire) != 0)
+            if (ring->dequeue(t)) consume(t);
+        for (auto& th : ts) th.join();
+        while (ring->dequeue(t)) consume(t);
+
+        STRESS_CHECK(ordered);
+        if (lossless) STRESS_CHECK(got == std::uint64_t{ PerProducer } * producers);
+        else          STRESS_CHECK(got + ring->dropped() == std::uint64_t{ PerProducer } * producers);
+    }
+
+    void mpsc_stress() {
+        mpsc_run<events::OverflowPolicy::Grow>(true);
+        mpsc_run<events::OverflowPolicy::Block>(true);
+        mpsc_run<events::OverflowPolicy::DropNewest>(false);
+    }
+
+    // ─── MPMCQueue: producers vs consumers, checksum ───────────────────────
+    void mpmc_stress() {
+        constexpr std::uint64_t PerProducer = 100'000;
+        const unsigned half = std::max(2u, thread_count() / 2);
+        MPMCQueue<std::uint64_t> q(1024);
+
+        std::atomic<std::uint64_t> sum{ 0 }, count{ 0 };
+        std::atomic<unsigned> producing{ half };
+        std::vector<std::thread> ts;
+        for (unsigned p = 0; p < half; ++p) {
+            ts.emplace_back([&, p] {
+                for (std::uint64_t i = 0; i < PerProducer; ++i)
+                    while (!q.enqueue(p * PerProducer + i)) std::this_thread::yield();
+                producing.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        for (unsigned c = 0; c < half; ++c) {
+            ts.emplace_back([&] {
+                std::uint64_t v = 0, localSum = 0, localCount = 0;
+                for (;;) {
+                    if (q.dequeue(v)) { localSum += v; ++localCount; continue; }
+                    if (producing.load(std::memory_order_acquire) != 0) { std::this_thread::yield(); continue; }
+                    // producers are done: whatever is left can be taken without racing them
+                    while (q.dequeue(v)) { localSum += v; ++localCount; }
+                    break;
+                }
+                sum.fetch_add(localSum, std::memory_order_relaxed);
+                count.fetch_add(localCount, std::memory_order_relaxed);
+            });
+        }
+        for (auto& t : ts) t.join();
+
+        const std::uint64_t n = PerProducer * half;
+        STRESS_CHECK(count.load() == n);
+        STRESS_CHECK(sum.load() == n * (n - 1) / 2);
+    }
+
+    // ─── TaskGraph: reused frame graph, nested and short-lived graphs ──────
+    Task one_shot(std::atomic<int>& hits) { hits.fetch_add(1, std::memory_order_relaxed); co_return; }
+
+    void taskgraph_stress() {
+        taskgraph::TaskGraph g(thread_count());
+        taskgraph::TaskGraph sub(0);
+
+        std::atomic<int> a{ 0 }, b{ 0 }, s1{ 0 }, s2{ 0 }, joins{ 0 };
+        bool ordered = true;
+        auto& sa = sub.AddWork("sa", [&] { s1.fetch_add(1); });
+        auto& sb = sub.AddWork("sb", [&] { s2.fetch_add(1); });
+        sub.AddDependency(sa, sb);
+        auto& A = g.AddWork("A", [&] { a.fetch_add(1); });
+        auto& B = g.AddWork("B", [&] { b.fetch_add(1); });
+        auto& S = g.AddSubgraph("sub", sub);
+        auto& J = g.AddWork("join", [&] { ordered &= s2.load() == a.load() && b.load() == a.load(); joins.fetch_add(1); });
+        g.AddDependency(A, S);
+        g.AddDependency(S, J);
+        g.AddDependency(B, J);
+
+        constexpr int Frames = 5000;
+        for (int f = 0; f < Frames; ++f) g.Run();
+        STRESS_CHECK(ordered);
+        STRESS_CHECK(joins.load() == Frames && s1.load() == Frames);
+
+        // graphs destroyed the moment WaitAll() returns
+        std::atomic<int> n{ 0 };
+        for (int r = 0; r < 1000; ++r) {
+            taskgraph::TaskGraph inner(0);
+            inner.AddWork("i", [&] { n.fetch_add(1); });
+            taskgraph::TaskGraph outer(2);
+            outer.AddSubgraph("inner", inner);
+            outer.AddWork("o", [&] { n.fetch_add(1); });
+            outer.Run();
+        }
+        STRESS_CHECK(n.load() == 2000);
+
+        // one-shot coroutine nodes, reclaimed by later submits
+        std::atomic<int> hits{ 0 };
+        for (int i = 0; i < 5000; ++i) g.Submit(std::make_unique<taskgraph::Node>(one_shot(hits)));
+        while (hits.load() != 5000) std::this_thread::yield();
+    }
+
+    // ─── CommandQueue: producer lanes vs a concurrent drainer ──────────────
+    void commandqueue_stress() {
+        core::CommandQueue q;
+        const unsigned producers = thread_count() - 1;
+        constexpr int PerProducer = 50'000;
+
+        std::atomic<std::int64_t> executed{ 0 };
+        std::atomic<unsigned> producing{ producers };
+        std::vector<int> lastSeen(producers, -1);
+        bool ordered = true;
+
+        std::vector<std::thread> ts;
+        for (unsigned p = 0; p < producers; ++p) {
+            ts.emplace_back([&, p] {
+                for (int i = 0; i < PerProducer; ++i) {
+                    q.enqueue([&, p, i] {
+                        ordered &= i > lastSeen[p];   // drain is single-threaded
+                        lastSeen[p] = i;
+                        executed.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+                producing.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        while (producing.load(std::memory_order_acquire) != 0) q.drain();
+        for (auto& t : ts) t.join();
+        q.drain();
+
+        STRESS_CHECK(ordered);
+        STRESS_CHECK(executed.load() == std::int64_t{ PerProducer } * producers);
+    }
+
+    template<typename Fn>
+    void section(const char* name, Fn&& fn) {
+        const int before = g_failures;
+        fn();
+        std::printf("%-14s %s\n", name, g_failures == before ? "ok" : "FAILED");
+        std::fflush(stdout);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+
+    jobs::SchedulerConfig cfg;
+    cfg.workers = thread_count() - 1;
+    jobs::scheduler().start(cfg);
+
+    for (int r = 0; r < rounds && g_failures == 0; ++r) {
+        std::printf("round %d/%d\n", r + 1, rounds);
+        section("deque", deque_stress);
+        section("scheduler", scheduler_stress);
+        section("mpsc_ring", mpsc_stress);
+        section("mpmc_queue", mpmc_stress);
+        section("taskgraph", taskgraph_stress);
+        section("commandqueue", commandqueue_stress);
+    }
+
+    jobs::scheduler().stop();
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,15 +22,25 @@
 // almond_allocator.hpp ‑ functional, header‑only C++20
 // -----------------------------------------------------
 //  ▸ linear_arena  : bump‑pointer scratch allocator
+//  ▸ growable_arena: bump‑pointer over chained blocks, markers, peak stats
+//  ▸ frame_arena() : per‑thread, double‑buffered growable_arena
 //  ▸ block_pool    : fixed‑block freelist allocator
+//  ▸ shared_block_pool / object_pool : lock‑free, growable, thread‑safe pools
+//  ▸ pool_resource : pmr adapter with size classes over shared_block_pool
 //
 //  All interfaces are free functions in almondnamespace::mem.
 //  Plug into std containers via <memory_resource>.
 #pragma once
 
+#include "aplatform.hpp"   // must always come first
+
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <memory_resource>
+#include <mutex>
 #include <new>
 #include <type_traits>
 #include <vector>
@@ -82,20 +92,235 @@ namespace almondnamespace::mem {
         std::byte* curr_;
     };
 
-    inline linear_arena& frame_arena() {
-        static std::byte storage[megabytes_<4>::value];   // 4 MiB scratch
-        static linear_arena arena{ storage, sizeof(storage) };
-        return arena;
+    // ─────────────────────────────────────────────────────────────────────────────
+    // 1b. growable_arena : bump pointer over a chain of blocks
+    //     overflow chains a new block instead of throwing; blocks are kept
+    //     across clear()/rewind() so a warmed‑up arena stops allocating
+    // ─────────────────────────────────────────────────────────────────────────────
+    class growable_arena final : public std::pmr::memory_resource {
+    public:
+        struct marker {
+            std::size_t block = 0;
+            std::size_t offset = 0;
+            std::size_t used = 0;
+        };
+
+        explicit growable_arena(std::size_t blockSize = megabytes_<1>::value)
+            : blockSize_{ blockSize } {
+        }
+
+        growable_arena(const growable_arena&) = delete;
+        growable_arena& operator=(const growable_arena&) = delete;
+
+        [[nodiscard]] marker mark() const noexcept { return { curr_, offset_, used_ }; }
+
+        /// drop everything allocated after `m` (does NOT run dtors)
+        void rewind(marker m) noexcept {
+            if (m.used > used_) return;
+            curr_ = m.block;
+            offset_ = m.offset;
+            used_ = m.used;
+        }
+
+        /// reset the arena (does NOT run dtors)
+        void clear() noexcept { rewind({}); }
+
+        /// clear() and free every block beyond the first
+        void trim() noexcept {
+            clear();
+            if (blocks_.size() > 1) blocks_.resize(1);
+        }
+
+        /// restart the peak counter (frame boundaries)
+        void reset_peak() noexcept { peak_ = used_; }
+
+        std::size_t used()     const noexcept { return used_; }
+        std::size_t peak()     const noexcept { return peak_; }
+        std::size_t blocks()   const noexcept { return blocks_.size(); }
+        std::size_t capacity() const noexcept {
+            std::size_t n = 0;
+            for (auto& b : blocks_) n += b.size;
+            return n;
+        }
+
+    private:
+        struct block {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t                  size = 0;
+        };
+
+        void* do_allocate(std::size_t n, std::size_t align) override {
+            for (;;) {
+                if (curr_ < blocks_.size()) {
+                    auto& b = blocks_[curr_];
+                    const auto base = reinterpret_cast<std::uintptr_t>(b.data.get());
+                    const auto adj = (align - ((base + offset_) % align)) % align;
+                    if (offset_ + adj + n <= b.size) {
+                        void* p = b.data.get() + offset_ + adj;
+                        offset_ += adj + n;
+                        used_ += adj + n;
+                        peak_ = std::max(peak_, used_);
+                        return p;
+                    }
+                    // the tail of this block is wasted until the next rewind
+                    used_ += b.size - offset_;
+                    offset_ = 0;
+                    ++curr_;
+                    // the next block is too small: pull forward a spare one that
+                    // fits, else give this request a block of its own right here
+                    if (curr_ < blocks_.size() && blocks_[curr_].size < n + align) {
+                        auto fit = std::find_if(blocks_.begin() + static_cast<std::ptrdiff_t>(curr_), blocks_.end(),
+                            [&](const block& blk) { return blk.size >= n + align; });
+                        if (fit != blocks_.end())
+                            std::swap(blocks_[curr_], *fit);
+                        else
+                            blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(curr_),
+                                block{ std::make_unique<std::byte[]>(n + align), n + align });
+                    }
+                    continue;
+                }
+                const std::size_t size = std::max(blockSize_, n + align);
+                blocks_.push_back({ std::make_unique<std::byte[]>(size), size });
+            }
+        }
+        void  do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+        bool  do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+            return this == &o;
+        }
+
+        std::size_t        blockSize_;
+        std::vector<block> blocks_;
+        std::size_t        curr_ = 0;     // block being bumped
+        std::size_t        offset_ = 0;   // bump offset inside blocks_[curr_]
+        std::size_t        used_ = 0;     // bytes consumed incl. padding and skipped tails
+        std::size_t        peak_ = 0;
+    };
+
+    /// rewinds `arena` to where it stood at construction
+    class ArenaScope {
+    public:
+        explicit ArenaScope(growable_arena& arena) noexcept
+            : arena_{ arena }, mark_{ arena.mark() } {
+        }
+        ~ArenaScope() { arena_.rewind(mark_); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        growable_arena& arena() noexcept { return arena_; }
+
+    private:
+        growable_arena&        arena_;
+        growable_arena::marker mark_;
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // 1c. frame arenas : one pair per thread, flipped by begin_frame()
+    //     memory from frame N stays valid through frame N+1; a thread's
+    //     arena for N+2 is cleared lazily on its first use in that frame
+    // ─────────────────────────────────────────────────────────────────────────────
+    struct frame_arena_stats {
+        std::size_t threads = 0;
+        std::size_t last_frame_peak = 0;   // bytes, summed over threads
+        std::size_t max_frame_peak = 0;    // worst frame seen per thread, summed
+        std::size_t capacity = 0;          // bytes reserved by all arenas
+    };
+
+    namespace _detail {
+        inline std::atomic<std::uint64_t>& frame_counter() noexcept {
+            static std::atomic<std::uint64_t> frame{ 0 };
+            return frame;
+        }
+
+        struct thread_frame_arenas {
+            growable_arena           arenas[2];
+            std::uint64_t            frame = 0;
+            // published for frame_arena_totals(); written only by the owning thread
+            std::atomic<std::size_t> lastPeak{ 0 };
+            std::atomic<std::size_t> maxPeak{ 0 };
+            std::atomic<std::size_t> capacity{ 0 };
+
+            thread_frame_arenas();
+            ~thread_frame_arenas();
+
+            growable_arena& current() {
+                const auto now = frame_counter().load(std::memory_order_acquire);
+                if (now != frame) {
+                    auto& prev = arenas[frame & 1];
+                    lastPeak.store(prev.peak(), std::memory_order_relaxed);
+                    maxPeak.store(std::max(maxPeak.load(std::memory_order_relaxed), prev.peak()), std::memory_order_relaxed);
+
+                    // skipped a frame or more: the other buffer is stale as well
+                    if (now - frame > 1) arenas[(now + 1) & 1].clear();
+                    auto& next = arenas[now & 1];
+                    next.clear();
+                    next.reset_peak();
+                    frame = now;
+                    capacity.store(arenas[0].capacity() + arenas[1].capacity(), std::memory_order_relaxed);
+                }
+                return arenas[now & 1];
+            }
+        };
+
+        inline std::mutex& frame_registry_mutex() {
+            static std::mutex m;
+            return m;
+        }
+
+        inline std::vector<thread_frame_arenas*>& frame_registry() {
+            static std::vector<thread_frame_arenas*> r;
+            return r;
+        }
+
+        inline thread_frame_arenas::thread_frame_arenas() {
+            std::lock_guard lock(frame_registry_mutex());
+            frame_registry().push_back(this);
+        }
+
+        inline thread_frame_arenas::~thread_frame_arenas() {
+            std::lock_guard lock(frame_registry_mutex());
+            auto& r = frame_registry();
+            r.erase(std::remove(r.begin(), r.end(), this), r.end());
+        }
+
+        inline thread_frame_arenas& local_frame_arenas() {
+            thread_local thread_frame_arenas arenas;
+            return arenas;
+        }
+    }
+
+    /// call once per frame from the main loop; flips every thread's arenas
+    inline std::uint64_t begin_frame() noexcept {
+        return _detail::frame_counter().fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    /// this thread's arena for the current frame (no locking)
+    inline growable_arena& frame_arena() {
+        return _detail::local_frame_arenas().current();
+    }
+
+    /// peak usage across every thread that has touched a frame arena
+    [[nodiscard]] inline frame_arena_stats frame_arena_totals() {
+        std::lock_guard lock(_detail::frame_registry_mutex());
+        frame_arena_stats s;
+        for (auto* t : _detail::frame_registry()) {
+            ++s.threads;
+            s.last_frame_peak += t->lastPeak.load(std::memory_order_relaxed);
+            s.max_frame_peak += t->maxPeak.load(std::memory_order_relaxed);
+            s.capacity += t->capacity.load(std::memory_order_relaxed);
+        }
+        return s;
     }
 
     // ─────────────────────────────────────────────────────────────────────────────
     // 2. block_pool : fixed‑size freelist for T
+    //     single‑threaded, inline storage; see shared_block_pool for the
+    //     thread‑safe, growable variant
     // ─────────────────────────────────────────────────────────────────────────────
     template<typename T, std::size_t N>
-        requires TriviallyDestructible<T>
     class block_pool {
     public:
-        constexpr block_pool() noexcept {
+        block_pool() noexcept {
             std::byte* head = &storage_[0];
             for (std::size_t i = 0; i < N - 1; ++i) {
                 *reinterpret_cast<std::byte**>(head) = head + block_size;
@@ -105,28 +330,251 @@ namespace almondnamespace::mem {
             freelist_ = &storage_[0];
         }
 
-        [[nodiscard]] T* allocate() {
+        block_pool(const block_pool&) = delete;
+        block_pool& operator=(const block_pool&) = delete;
+
+        template<typename... Args>
+        [[nodiscard]] T* allocate(Args&&... args) {
             if (!freelist_) throw std::bad_alloc{};
             std::byte* p = freelist_;
-            freelist_ = *reinterpret_cast<std::byte**>(freelist_);
-            return new (p) T;                       // placement‑new
+            std::byte* next = *reinterpret_cast<std::byte**>(freelist_);
+            T* obj = new (p) T(std::forward<Args>(args)...);   // placement‑new; may throw
+            freelist_ = next;
+            return obj;
         }
 
         void deallocate(T* obj) noexcept {
-            obj->~T();                              // trivial, but keeps API honest
+            obj->~T();
             std::byte* p = reinterpret_cast<std::byte*>(obj);
             *reinterpret_cast<std::byte**>(p) = freelist_;
             freelist_ = p;
         }
 
     private:
+        // a free block holds the next pointer, so it must fit one
+        static constexpr std::size_t block_align = std::max(alignof(T), alignof(std::byte*));
         static constexpr std::size_t block_size =
-            (sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+            (std::max(sizeof(T), sizeof(std::byte*)) + block_align - 1) / block_align * block_align;
 
-        alignas(alignof(T)) std::byte storage_[block_size * N];
+        alignas(block_align) std::byte storage_[block_size * N];
         std::byte* freelist_;
     };
 
+    // ─────────────────────────────────────────────────────────────────────────────
+    // 3. shared_block_pool : thread‑safe, growable fixed‑size blocks
+    //     alloc/free are lock‑free (tagged index head, no ABA); growth takes a
+    //     mutex once per page. pages are never released before destruction,
+    //     so a stale pop can always read a block's header safely
+    // ─────────────────────────────────────────────────────────────────────────────
+    class shared_block_pool {
+    public:
+        static constexpr std::size_t max_pages = 4096;
+
+        explicit shared_block_pool(std::size_t blockSize,
+            std::size_t blockAlign = alignof(std::max_align_t),
+            std::size_t blocksPerPage = 256)
+            : align_{ std::max(blockAlign, alignof(header)) },
+            headerSize_{ round_up(sizeof(header), align_) },
+            stride_{ headerSize_ + round_up(std::max<std::size_t>(blockSize, 1), align_) },
+            blockSize_{ blockSize },
+            perPage_{ std::max<std::size_t>(blocksPerPage, 1) },
+            pages_{ std::make_unique<std::atomic<std::byte*>[]>(max_pages) } {
+        }
+
+        ~shared_block_pool() {
+            const auto n = pageCount_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < n; ++i)
+                ::operator delete(pages_[i].load(std::memory_order_relaxed), std::align_val_t{ align_ });
+        }
+
+        shared_block_pool(const shared_block_pool&) = delete;
+        shared_block_pool& operator=(const shared_block_pool&) = delete;
+
+        [[nodiscard]] void* allocate() {
+            for (;;) {
+                auto head = head_.load(std::memory_order_acquire);
+                while (head & index_mask) {
+                    const auto idx = static_cast<std::uint32_t>(head & index_mask) - 1;
+                    const auto next = header_at(idx).next.load(std::memory_order_relaxed);
+                    if (head_.compare_exchange_weak(head, retag(head, next),
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        inUse_.fetch_add(1, std::memory_order_relaxed);
+                        return payload_at(idx);
+                    }
+                }
+                grow();
+            }
+        }
+
+        void deallocate(void* p) noexcept {
+            if (!p) return;
+            auto& h = *reinterpret_cast<header*>(static_cast<std::byte*>(p) - headerSize_);
+            auto head = head_.load(std::memory_order_relaxed);
+            do {
+                h.next.store(static_cast<std::uint32_t>(head & index_mask), std::memory_order_relaxed);
+            } while (!head_.compare_exchange_weak(head, retag(head, h.self + 1),
+                std::memory_order_release, std::memory_order_relaxed));
+            inUse_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        std::size_t block_size() const noexcept { return blockSize_; }
+        std::size_t pages()      const noexcept { return pageCount_.load(std::memory_order_relaxed); }
+        std::size_t capacity()   const noexcept { return pages() * perPage_; }
+        std::size_t in_use()     const noexcept { return inUse_.load(std::memory_order_relaxed); }
+
+    private:
+        // sits just before every payload; `next` is atomic because a racing
+        // pop may read it while the block is being handed out elsewhere
+        struct header {
+            std::atomic<std::uint32_t> next{ 0 };   // free‑list successor, index + 1 (0 = end)
+            std::uint32_t              self = 0;    // own index
+        };
+
+        static constexpr std::uint64_t index_mask = 0xFFFF'FFFFull;
+
+        static constexpr std::size_t round_up(std::size_t n, std::size_t a) noexcept {
+            return (n + a - 1) / a * a;
+        }
+
+        // head = [tag:32][index + 1:32]; bumping the tag on every swap defeats ABA
+        static constexpr std::uint64_t retag(std::uint64_t head, std::uint32_t link) noexcept {
+            return (((head >> 32) + 1) << 32) | link;
+        }
+
+        std::byte* block_at(std::uint32_t idx) const noexcept {
+            return pages_[idx / perPage_].load(std::memory_order_acquire) + (idx % perPage_) * stride_;
+        }
+        header& header_at(std::uint32_t idx) const noexcept {
+            return *reinterpret_cast<header*>(block_at(idx));
+        }
+        void* payload_at(std::uint32_t idx) const noexcept { return block_at(idx) + headerSize_; }
+
+        void grow() {
+            std::lock_guard lock(growMutex_);
+            if (head_.load(std::memory_order_acquire) & index_mask) return;   // someone freed or grew
+
+            const auto p = pageCount_.load(std::memory_order_relaxed);
+            if (p == max_pages || (p + 1) * perPage_ >= index_mask) throw std::bad_alloc{};
+
+            auto* page = static_cast<std::byte*>(::operator new(stride_ * perPage_, std::align_val_t{ align_ }));
+            const auto first = static_cast<std::uint32_t>(p * perPage_);
+            for (std::size_t i = 0; i < perPage_; ++i) {
+                auto* h = new (page + i * stride_) header{};
+                h->self = first + static_cast<std::uint32_t>(i);
+                h->next.store(i + 1 < perPage_ ? h->self + 2 : 0, std::memory_order_relaxed);
+            }
+            pages_[p].store(page, std::memory_order_release);
+            pageCount_.store(p + 1, std::memory_order_release);
+
+            // splice the whole page in front of whatever was freed meanwhile
+            auto& last = *reinterpret_cast<header*>(page + (perPage_ - 1) * stride_);
+            auto head = head_.load(std::memory_order_relaxed);
+            do {
+                last.next.store(static_cast<std::uint32_t>(head & index_mask), std::memory_order_relaxed);
+            } while (!head_.compare_exchange_weak(head, retag(head, first + 1),
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        std::size_t align_;
+        std::size_t headerSize_;
+        std::size_t stride_;
+        std::size_t blockSize_;
+        std::size_t perPage_;
+
+        std::unique_ptr<std::atomic<std::byte*>[]> pages_;
+        std::atomic<std::size_t>   pageCount_{ 0 };
+        std::atomic<std::uint64_t> head_{ 0 };
+        std::atomic<std::size_t>   inUse_{ 0 };
+        std::mutex                 growMutex_;
+    };
+
+    /// typed front end over shared_block_pool; runs ctors/dtors, any T
+    template<typename T>
+    class object_pool {
+    public:
+        explicit object_pool(std::size_t blocksPerPage = 256)
+            : pool_{ sizeof(T), alignof(T), blocksPerPage } {
+        }
+
+        template<typename... Args>
+        [[nodiscard]] T* create(Args&&... args) {
+            void* p = pool_.allocate();
+            try {
+                return new (p) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                pool_.deallocate(p);
+                throw;
+            }
+        }
+
+        void destroy(T* obj) noexcept {
+            if (!obj) return;
+            obj->~T();
+            pool_.deallocate(obj);
+        }
+
+        shared_block_pool&       blocks() noexcept { return pool_; }
+        const shared_block_pool& blocks() const noexcept { return pool_; }
+
+    private:
+        shared_block_pool pool_;
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // 4. pool_resource : pmr adapter, power‑of‑two size classes 16..1024
+    //     small requests hit a lock‑free shared_block_pool; anything larger
+    //     or over‑aligned goes to `upstream`
+    // ─────────────────────────────────────────────────────────────────────────────
+    class pool_resource final : public std::pmr::memory_resource {
+    public:
+        static constexpr std::size_t min_block = 16;
+        static constexpr std::size_t max_block = 1024;
+        static constexpr std::size_t class_count = 7;   // 16, 32, … 1024
+
+        explicit pool_resource(std::size_t blocksPerPage = 256,
+            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : upstream_{ upstream } {
+            for (std::size_t i = 0; i < class_count; ++i)
+                classes_[i] = std::make_unique<shared_block_pool>(min_block << i, alignof(std::max_align_t), blocksPerPage);
+        }
+
+        std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+        const shared_block_pool&   size_class(std::size_t i) const noexcept { return *classes_[i]; }
+
+    private:
+        static std::size_t class_of(std::size_t n) noexcept {
+            std::size_t i = 0;
+            while ((min_block << i) < n) ++i;
+            return i;
+        }
+
+        static bool pooled(std::size_t n, std::size_t align) noexcept {
+            return n <= max_block && align <= alignof(std::max_align_t);
+        }
+
+        void* do_allocate(std::size_t n, std::size_t align) override {
+            if (!pooled(n, align)) return upstream_->allocate(n, align);
+            return classes_[class_of(n)]->allocate();
+        }
+        void do_deallocate(void* p, std::size_t n, std::size_t align) override {
+            if (!pooled(n, align)) { upstream_->deallocate(p, n, align); return; }
+            classes_[class_of(n)]->deallocate(p);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+            return this == &o;
+        }
+
+        std::pmr::memory_resource*         upstream_;
+        std::unique_ptr<shared_block_pool> classes_[class_count];
+    };
+
+    /// process‑wide pool for hot small allocations (event channel spill lists, …)
+    inline pool_resource& shared_pool_resource() {
+        static pool_resource r;
+        return r;
+    }
+
     // ─────────────────────────────────────────────────────────────────────────────
     // usage helpers
     // ─────────────────────────────────────────────────────────────────────────────
@@ -136,3 +584,5 @@ namespace almondnamespace::mem {
         auto mem = arena.allocate(sizeof(T), alignof(T));
         return new (mem) T(std::forward<Args>(args)...);
     }
+
+} // namespace almondnamespace::mem
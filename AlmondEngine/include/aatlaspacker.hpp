@@ -0,0 +1,322 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aatlaspacker.hpp
+#pragma once
+
+#include "aplatform.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace almondnamespace::atlaspacker
+{
+    using u32 = std::uint32_t;
+    using u64 = std::uint64_t;
+
+    struct PackRect { u32 x = 0, y = 0, width = 0, height = 0; };
+
+    struct PackerStats
+    {
+        u64 totalArea = 0;
+        u64 usedArea = 0;
+        u64 largestFreeArea = 0;   // biggest single rectangle still placeable
+        u32 freeRects = 0;         // free rects (MaxRects) or skyline segments
+        u32 inserted = 0;
+        u32 rejected = 0;
+
+        [[nodiscard]] double occupancy() const noexcept {
+            return totalArea ? static_cast<double>(usedArea) / static_cast<double>(totalArea) : 0.0;
+        }
+
+        // 0 = all free space in one block, →1 = free space shattered into slivers
+        [[nodiscard]] double fragmentation() const noexcept {
+            const u64 freeArea = totalArea - usedArea;
+            return freeArea ? 1.0 - static_cast<double>(largestFreeArea) / static_cast<double>(freeArea) : 0.0;
+        }
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Skyline bottom‑left: the packed outline is a list of horizontal segments;
+    // a rect sits on the lowest run of segments it spans. O(segments) per insert.
+    // ─────────────────────────────────────────────────────────────────────────
+    class SkylinePacker
+    {
+    public:
+        void reset(u32 width, u32 height)
+        {
+            width_ = width;
+            height_ = height;
+            skyline_.assign(1, Segment{ 0, 0, width });
+            stats_ = {};
+            stats_.totalArea = static_cast<u64>(width) * height;
+        }
+
+        std::optional<PackRect> insert(u32 w, u32 h)
+        {
+            std::size_t bestIndex = npos;
+            u32 bestY = std::numeric_limits<u32>::max();
+            u32 bestWidth = std::numeric_limits<u32>::max();
+
+            for (std::size_t i = 0; i < skyline_.size(); ++i) {
+                auto y = fit(i, w, h);
+                if (!y) continue;
+                // lowest resting point wins; narrower segment breaks ties
+                if (*y < bestY || (*y == bestY && skyline_[i].width < bestWidth)) {
+                    bestIndex = i;
+                    bestY = *y;
+                    bestWidth = skyline_[i].width;
+                }
+            }
+
+            if (bestIndex == npos) {
+                ++stats_.rejected;
+                return std::nullopt;
+            }
+
+            PackRect r{ skyline_[bestIndex].x, bestY, w, h };
+            add_level(bestIndex, r);
+            stats_.usedArea += static_cast<u64>(w) * h;
+            ++stats_.inserted;
+            return r;
+        }
+
+        [[nodiscard]] PackerStats stats() const
+        {
+            PackerStats s = stats_;
+            s.freeRects = static_cast<u32>(skyline_.size());
+            // largest free block: the tallest full‑height column strip over a segment
+            for (auto& seg : skyline_)
+                s.largestFreeArea = std::max<u64>(s.largestFreeArea, static_cast<u64>(seg.width) * (height_ - seg.y));
+            return s;
+        }
+
+    private:
+        struct Segment { u32 x, y, width; };
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        // y at which a w×h rect starting at segment i would rest, if it fits
+        std::optional<u32> fit(std::size_t i, u32 w, u32 h) const
+        {
+            if (skyline_[i].x + w > width_) return std::nullopt;
+            u32 y = 0;
+            u32 remaining = w;
+            for (std::size_t j = i; remaining > 0; ++j) {
+                if (j >= skyline_.size()) return std::nullopt;
+                y = std::max(y, skyline_[j].y);
+                if (y + h > height_) return std::nullopt;
+                remaining -= std::min(remaining, skyline_[j].width);
+            }
+            return y;
+        }
+
+        void add_level(std::size_t index, const PackRect& r)
+        {
+            skyline_.insert(skyline_.begin() + static_cast<std::ptrdiff_t>(index), Segment{ r.x, r.y + r.height, r.width });
+
+            // trim/remove the segments now shadowed by the new one
+            for (std::size_t i = index + 1; i < skyline_.size(); ) {
+                auto& prev = skyline_[i - 1];
+                auto& cur = skyline_[i];
+                if (cur.x >= prev.x + prev.width) break;
+                const u32 shrink = prev.x + prev.width - cur.x;
+                if (cur.width <= shrink) {
+                    skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i));
+                    continue;
+                }
+                cur.x += shrink;
+                cur.width -= shrink;
+                break;
+            }
+
+            // merge neighbours at equal height
+            for (std::size_t i = 0; i + 1 < skyline_.size(); ) {
+                if (skyline_[i].y == skyline_[i + 1].y) {
+                    skyline_[i].width += skyline_[i + 1].width;
+                    skyline_.erase(skyline_.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+
+        u32 width_ = 0;
+        u32 height_ = 0;
+        std::vector<Segment> skyline_;
+        PackerStats stats_{};
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // MaxRects with best‑short‑side‑fit: keeps the maximal free rectangles and
+    // picks the one leaving the smallest leftover on its shorter side.
+    // ─────────────────────────────────────────────────────────────────────────
+    class MaxRectsPacker
+    {
+    public:
+        void reset(u32 width, u32 height)
+        {
+            free_.assign(1, PackRect{ 0, 0, width, height });
+            stats_ = {};
+            stats_.totalArea = static_cast<u64>(width) * height;
+        }
+
+        std::optional<PackRect> insert(u32 w, u32 h)
+        {
+            const PackRect* best = nullptr;
+            u32 bestShort = std::numeric_limits<u32>::max();
+            u32 bestLong = std::numeric_limits<u32>::max();
+
+            for (auto& f : free_) {
+                if (f.width < w || f.height < h) continue;
+                const u32 dw = f.width - w;
+                const u32 dh = f.height - h;
+                const u32 s = std::min(dw, dh);
+                const u32 l = std::max(dw, dh);
+                if (s < bestShort || (s == bestShort && l < bestLong)) {
+                    best = &f;
+                    bestShort = s;
+                    bestLong = l;
+                }
+            }
+
+            if (!best) {
+                ++stats_.rejected;
+                return std::nullopt;
+            }
+
+            const PackRect placed{ best->x, best->y, w, h };
+            place(placed);
+            stats_.usedArea += static_cast<u64>(w) * h;
+            ++stats_.inserted;
+            return placed;
+        }
+
+        [[nodiscard]] PackerStats stats() const
+        {
+            PackerStats s = stats_;
+            s.freeRects = static_cast<u32>(free_.size());
+            for (auto& f : free_)
+                s.largestFreeArea = std::max<u64>(s.largestFreeArea, static_cast<u64>(f.width) * f.height);
+            return s;
+        }
+
+    private:
+        static bool intersects(const PackRect& a, const PackRect& b) noexcept
+        {
+            return a.x < b.x + b.width && b.x < a.x + a.width
+                && a.y < b.y + b.height && b.y < a.y + a.height;
+        }
+
+        static bool contains(const PackRect& outer, const PackRect& inner) noexcept
+        {
+            return inner.x >= outer.x && inner.y >= outer.y
+                && inner.x + inner.width <= outer.x + outer.width
+                && inner.y + inner.height <= outer.y + outer.height;
+        }
+
+        void place(const PackRect& used)
+        {
+            std::vector<PackRect> next;
+            next.reserve(free_.size() + 4);
+
+            for (auto& f : free_) {
+                if (!intersects(f, used)) { next.push_back(f); continue; }
+
+                // split f into up to four maximal pieces around `used`
+                if (used.x > f.x)
+                    next.push_back({ f.x, f.y, used.x - f.x, f.height });
+                if (used.x + used.width < f.x + f.width)
+                    next.push_back({ used.x + used.width, f.y, f.x + f.width - (used.x + used.width), f.height });
+                if (used.y > f.y)
+                    next.push_back({ f.x, f.y, f.width, used.y - f.y });
+                if (used.y + used.height < f.y + f.height)
+                    next.push_back({ f.x, used.y + used.height, f.width, f.y + f.height - (used.y + used.height) });
+            }
+
+            // drop rects fully contained in another
+            for (std::size_t i = 0; i < next.size(); ++i) {
+                for (std::size_t j = i + 1; j < next.size(); ) {
+                    if (contains(next[i], next[j])) {
+                        next[j] = next.back();
+                        next.pop_back();
+                    }
+                    else if (contains(next[j], next[i])) {
+                        next[i] = next[j];
+                        next[j] = next.back();
+                        next.pop_back();
+                        j = i + 1;
+                    }
+                    else {
+                        ++j;
+                    }
+                }
+            }
+
+            free_ = std::move(next);
+        }
+
+        std::vector<PackRect> free_;
+        PackerStats stats_{};
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // AtlasPacker : the one TextureAtlas holds
+    // ─────────────────────────────────────────────────────────────────────────
+    enum class PackerKind : std::uint8_t { Skyline, MaxRects };
+
+    class AtlasPacker
+    {
+    public:
+        AtlasPacker() = default;
+        AtlasPacker(PackerKind kind, u32 width, u32 height) { reset(kind, width, height); }
+
+        void reset(PackerKind kind, u32 width, u32 height)
+        {
+            if (kind == PackerKind::Skyline) impl_.emplace<SkylinePacker>();
+            else                             impl_.emplace<MaxRectsPacker>();
+            std::visit([&](auto& p) { p.reset(width, height); }, impl_);
+        }
+
+        std::optional<PackRect> insert(u32 w, u32 h)
+        {
+            return std::visit([&](auto& p) { return p.insert(w, h); }, impl_);
+        }
+
+        [[nodiscard]] PackerStats stats() const
+        {
+            return std::visit([](const auto& p) { return p.stats(); }, impl_);
+        }
+
+        [[nodiscard]] PackerKind kind() const noexcept
+        {
+            return std::holds_alternative<SkylinePacker>(impl_) ? PackerKind::Skyline : PackerKind::MaxRects;
+        }
+
+    private:
+        std::variant<MaxRectsPacker, SkylinePacker> impl_;
+    };
+
+} // namespace almondnamespace::atlaspacker
@@ -25,11 +25,14 @@
 #include "aplatform.hpp"
 #include "atexture.hpp"
 #include "aimageloader.hpp"
+#include "aatlaspacker.hpp"
+#include "amemorytracker.hpp"
 
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <optional>
+#include <utility>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -68,6 +71,23 @@ namespace almondnamespace
         }
     };
 
+    struct AtlasDirtyRect
+    {
+        u32 x = 0, y = 0;
+        u32 width = 0, height = 0;
+    };
+
+    // What changed in pixel_data between two consume_dirty_regions() calls.
+    // A backend whose last uploaded version != since_version missed a batch
+    // and must re-upload the whole atlas; `full` asks for the same.
+    struct AtlasDirtyRegions
+    {
+        u64 since_version = 0;
+        u64 version = 0;
+        bool full = false;
+        std::vector<AtlasDirtyRect> rects;
+    };
+
     struct AtlasConfig 
     {
         std::string name;
@@ -75,6 +95,7 @@ namespace almondnamespace
         u32 height = 2048;
         bool generate_mipmaps = false;
         int index = 0; // <-- NEW: so you can assign index at creation
+        atlaspacker::PackerKind packer = atlaspacker::PackerKind::MaxRects;
     };
 
     struct TextureAtlas {
@@ -98,7 +119,7 @@ namespace almondnamespace
             atlas.height = config.height;
             atlas.has_mipmaps = config.generate_mipmaps;
             atlas.pixel_data.resize(static_cast<size_t>(atlas.width) * atlas.height * 4, 0);
-            atlas.occupancy.assign(atlas.height, std::vector<bool>(atlas.width, false));
+            atlas.packer.reset(config.packer, atlas.width, atlas.height);
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
             std::cerr << "[Atlas] Created '" << atlas.name << "' ("
                 << atlas.width << "x" << atlas.height
@@ -111,6 +132,7 @@ namespace almondnamespace
 
         std::optional<AtlasEntry> add_entry(const std::string& id, const Texture& tex) 
         {
+            mem::MemTagScope memTag(mem::MemTag::Atlas);
             if (tex.width == 0 || tex.height == 0 || tex.pixels.empty()) {
                 std::cerr << "[Atlas] Rejected empty texture '" << id << "'\n";
                 return std::nullopt;
@@ -170,6 +192,8 @@ namespace almondnamespace
             AtlasEntry entry{ entryIndex, id, region, tex.pixels, tex.width, tex.height };
             entries.push_back(entry);
             lookup.emplace(id, region);
+            if (composited == entries.size() - 1) ++composited;
+            mark_dirty({ x, y, tex.width, tex.height });
             ++version;
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
             std::cerr << "[Atlas] Added '" << id << "' at (" << x << ", " << y
@@ -178,6 +202,38 @@ namespace almondnamespace
             return entry;
         }
 
+        /// Packs a batch tallest-first (much tighter than arrival order).
+        /// Results are returned in input order; nullopt marks rejects.
+        std::vector<std::optional<AtlasEntry>> add_entries(
+            const std::vector<std::pair<std::string, const Texture*>>& batch)
+        {
+            std::vector<std::optional<AtlasEntry>> results(batch.size());
+
+            std::vector<std::size_t> order(batch.size());
+            for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                const Texture* ta = batch[a].second;
+                const Texture* tb = batch[b].second;
+                const u32 ha = ta ? ta->height : 0;
+                const u32 hb = tb ? tb->height : 0;
+                if (ha != hb) return ha > hb;
+                return (ta ? ta->width : 0) > (tb ? tb->width : 0);
+            });
+
+            for (std::size_t i : order) {
+                const auto& [id, tex] = batch[i];
+                if (!tex) {
+                    std::cerr << "[Atlas] Rejected null texture '" << id << "'\n";
+                    continue;
+                }
+                results[i] = add_entry(id, *tex);
+            }
+            return results;
+        }
+
+        /// Occupancy and fragmentation of the packer's free space.
+        [[nodiscard]] atlaspacker::PackerStats pack_stats() const { return packer.stats(); }
+
 		/// Adds a slice entry without new pixel data, just references existing pixels.
         std::optional<AtlasEntry> add_slice_entry(const std::string& id, int x, int y, int w, int h)
         {
@@ -217,6 +273,8 @@ namespace almondnamespace
 
             entries.emplace_back(entry);
             lookup.emplace(id, region);
+            if (composited == entries.size() - 1) ++composited;
+            mark_dirty(AtlasDirtyRect{ region.x, region.y, region.width, region.height });
             ++version;
 
 #if defined(DEBUG_TEXTURE_RENDERING_VERBOSE)
@@ -233,52 +291,116 @@ namespace almondnamespace
             return (it != lookup.end()) ? std::optional{ it->second } : std::nullopt;
         }
 
+        /// Composites entries not yet in pixel_data. Only a missing/mis-sized
+        /// buffer triggers a full zero-fill; otherwise existing pixels (and any
+        /// slice sources written straight into pixel_data) are left alone.
         void rebuild_pixels() const {
+            mem::MemTagScope memTag(mem::MemTag::Atlas);
             const size_t size = static_cast<size_t>(width) * height * 4;
-            if (pixel_data.size() != size)
-                pixel_data.resize(size);
+            if (pixel_data.size() != size) {
+                pixel_data.assign(size, 0);
+                composited = 0;
+                dirty_full = true;
+            }
 
-            std::fill(pixel_data.begin(), pixel_data.end(), 0);
-            const size_t stride = static_cast<size_t>(width) * 4;
+            if (composited == entries.size())
+                return;
 
-            for (const auto& entry : entries) {
-                for (u32 row = 0; row < entry.texHeight; ++row) {
-                    auto dst = pixel_data.data() + ((entry.region.y + row) * stride) + (entry.region.x * 4);
-                    auto src = entry.pixels.data() + (row * entry.texWidth * 4);
-                    std::copy_n(src, entry.texWidth * 4, dst);
-                }
+            for (size_t i = composited; i < entries.size(); ++i)
+                composite_entry(entries[i]);
+
+            composited = entries.size();
+            ++version;
+        }
+
+        /// Replaces the pixels of an existing entry in place (same size) and
+        /// dirties only its rectangle — for glyph caches and procedural tiles.
+        bool update_entry_pixels(const std::string& id, const std::vector<u8>& pixels)
+        {
+            auto it = std::find_if(entries.begin(), entries.end(),
+                [&](const AtlasEntry& e) { return e.name == id; });
+            if (it == entries.end() || it->pixels.size() != pixels.size() || pixels.empty()) {
+                std::cerr << "[Atlas] Cannot update pixels of '" << id << "'\n";
+                return false;
             }
 
+            it->pixels = pixels;
+            if (pixel_data.size() == static_cast<size_t>(width) * height * 4)
+                composite_entry(*it);
             ++version;
+            return true;
+        }
+
+        /// Forces the next rebuild_pixels() to re-composite everything.
+        void invalidate_pixels() const {
+            pixel_data.clear();
+            composited = 0;
+        }
+
+        /// Hands the accumulated dirty rectangles to the caller and resets the
+        /// list. Many/large rects collapse into a single full-atlas update.
+        AtlasDirtyRegions consume_dirty_regions() const
+        {
+            AtlasDirtyRegions out;
+            out.since_version = dirty_since;
+            out.version = version;
+
+            u64 area = 0;
+            for (const auto& r : dirty_rects) area += static_cast<u64>(r.width) * r.height;
+            out.full = dirty_full
+                || dirty_rects.size() > max_dirty_rects
+                || area * 2 > static_cast<u64>(width) * height;
+
+            if (!out.full) out.rects = std::move(dirty_rects);
+
+            dirty_rects.clear();
+            dirty_full = false;
+            dirty_since = version;
+            return out;
+        }
+
+        /// Copies one rectangle of pixel_data into a tightly packed RGBA buffer
+        /// (for APIs whose sub-image update has no row-stride parameter).
+        void copy_region(const AtlasDirtyRect& r, std::vector<u8>& out) const
+        {
+            const size_t rowBytes = static_cast<size_t>(r.width) * 4;
+            const size_t stride = static_cast<size_t>(width) * 4;
+            out.resize(rowBytes * r.height);
+            for (u32 row = 0; row < r.height; ++row) {
+                const u8* src = pixel_data.data() + (r.y + row) * stride + r.x * 4;
+                std::copy_n(src, rowBytes, out.data() + row * rowBytes);
+            }
         }
 
     private:
         std::unordered_map<std::string, AtlasRegion> lookup;
-        std::vector<std::vector<bool>> occupancy;
+        atlaspacker::AtlasPacker packer;
 
-        std::optional<std::pair<u32, u32>> try_pack(u32 w, u32 h) {
-            for (u32 y = 0; y + h <= height; ++y) {
-                for (u32 x = 0; x + w <= width; ++x) {
-                    if (can_place(x, y, w, h)) {
-                        mark_used(x, y, w, h);
-                        return { std::pair{x, y} };
-                    }
-                }
-            }
-            return std::nullopt;
+        static constexpr size_t max_dirty_rects = 64;
+        mutable size_t composited = 0;      // entries[0, composited) are in pixel_data
+        mutable std::vector<AtlasDirtyRect> dirty_rects;
+        mutable bool dirty_full = true;     // first upload is always whole
+        mutable u64 dirty_since = 0;
+
+        void mark_dirty(const AtlasDirtyRect& r) const {
+            if (!dirty_full) dirty_rects.push_back(r);
         }
 
-        bool can_place(u32 x, u32 y, u32 w, u32 h) const {
-            for (u32 dy = 0; dy < h; ++dy)
-                for (u32 dx = 0; dx < w; ++dx)
-                    if (occupancy[y + dy][x + dx]) return false;
-            return true;
+        void composite_entry(const AtlasEntry& entry) const {
+            if (entry.pixels.empty()) return; // slices reference pixels already in place
+            const size_t stride = static_cast<size_t>(width) * 4;
+            for (u32 row = 0; row < entry.texHeight; ++row) {
+                auto dst = pixel_data.data() + ((entry.region.y + row) * stride) + (entry.region.x * 4);
+                auto src = entry.pixels.data() + (row * entry.texWidth * 4);
+                std::copy_n(src, entry.texWidth * 4, dst);
+            }
+            mark_dirty({ entry.region.x, entry.region.y, entry.texWidth, entry.texHeight });
         }
 
-        void mark_used(u32 x, u32 y, u32 w, u32 h) {
-            for (u32 dy = 0; dy < h; ++dy)
-                for (u32 dx = 0; dx < w; ++dx)
-                    occupancy[y + dy][x + dx] = true;
+        std::optional<std::pair<u32, u32>> try_pack(u32 w, u32 h) {
+            if (auto r = packer.insert(w, h))
+                return std::pair{ r->x, r->y };
+            return std::nullopt;
         }
     };
 
@@ -22,42 +22,243 @@
 // acommandqueue.hpp
 #pragma once
 
+#include "aplatform.hpp"   // must always come first
+
+#include "aallocator.hpp"  // mem::object_pool
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace almondnamespace::core {
 
+    // Render command buffer.
+    //  ▸ commands are recorded into chunked byte streams: a small header
+    //    (invoke/destroy thunks + stride) followed by the callable or POD
+    //    payload inline, so recording does not allocate once chunks are warm
+    //  ▸ producers write to one of LaneCount lanes picked per thread; each
+    //    lane keeps its own lock, so producers on different threads do not
+    //    contend. Order is preserved per producer thread
+    //  ▸ drain() takes every lane's chunks, replays them in one linear pass
+    //    and hands the chunks back for reuse
+    //  ▸ standard chunks come from one lock‑free mem::object_pool shared by
+    //    every queue, so lanes warming up on worker threads never hit malloc
     struct CommandQueue {
         using RenderCommand = std::function<void()>;
 
-        std::queue<RenderCommand>& get_queue() { return commands; }
-        std::mutex& get_mutex() { return mutex; }
+        static constexpr std::size_t LaneCount = 8;
+        static constexpr std::size_t ChunkBytes = 16 * 1024;
+
+        // touch the chunk pool first so it outlives every queue, static ones included
+        CommandQueue() { (void)chunk_pool(); }
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        ~CommandQueue() {
+            for (auto& lane : lanes) destroy_all(lane.chunks);
+        }
+
+        // any void() callable, stored inline
+        template<typename F>
+            requires std::is_invocable_r_v<void, std::decay_t<F>&>
+        void enqueue(F&& fn) {
+            using Fn = std::decay_t<F>;
+            static_assert(alignof(Fn) <= RecordAlign, "over-aligned render command");
+            auto& lane = my_lane();
+            std::scoped_lock lock(lane.lock);
+            const std::size_t stride = stride_for(sizeof(Fn));
+            std::byte* at = reserve(lane, stride);
+            // construct before committing: if Fn's copy/move throws, the
+            // record was never published and drain() cannot run it
+            new (at + HeaderBytes) Fn(std::forward<F>(fn));
+            commit(lane, at, stride,
+                [](void* p) { (*static_cast<Fn*>(p))(); },
+                std::is_trivially_destructible_v<Fn> ? nullptr : +[](void* p) { static_cast<Fn*>(p)->~Fn(); });
+        }
 
+        // kept for std::function callers; an empty function records nothing
         void enqueue(RenderCommand cmd) {
-            std::scoped_lock lock(mutex);
-            commands.push(std::move(cmd));
+            if (!cmd) return;
+            enqueue<RenderCommand>(std::move(cmd));
+        }
+
+        // POD opcode: a plain function plus a trivially copyable payload
+        template<typename P>
+            requires std::is_trivially_copyable_v<P>
+        void enqueue(void (*op)(const P&), const P& payload) {
+            struct Op {
+                void (*op)(const P&);
+                P    payload;
+                void operator()() const { op(payload); }
+            };
+            enqueue(Op{ op, payload });
         }
 
         bool drain() {
-            std::queue<RenderCommand> localCommands;
-            {
-                std::scoped_lock lock(mutex);
-                if (commands.empty()) return false;
-                localCommands.swap(commands);
+            std::scoped_lock drainLock(drainMutex);
+            bool any = false;
+            for (auto& lane : lanes) {
+                {
+                    std::scoped_lock lock(lane.lock);
+                    if (lane.chunks.empty()) continue;
+                    replay.swap(lane.chunks);
+                }
+                any = true;
+                try {
+                    run_all(replay);
+                }
+                catch (...) {
+                    replay.clear();   // records already destroyed by run_all
+                    throw;
+                }
+                {
+                    std::scoped_lock lock(lane.lock);
+                    for (auto& c : replay) {
+                        c.used = 0;
+                        if (c.size == ChunkBytes) lane.spare.push_back(std::move(c));   // oversized ones are dropped
+                    }
+                }
+                replay.clear();
             }
+            return any;
+        }
 
-            while (!localCommands.empty()) {
-                auto cmd = std::move(localCommands.front());
-                localCommands.pop();
-                if (cmd) cmd();
+    private:
+        static constexpr std::size_t RecordAlign = alignof(std::max_align_t);
+
+        struct Header {
+            void (*invoke)(void*);
+            void (*destroy)(void*);     // null for trivially destructible payloads
+            std::uint32_t stride;       // header + payload, rounded to RecordAlign
+        };
+
+        static constexpr std::size_t HeaderBytes =
+            (sizeof(Header) + RecordAlign - 1) / RecordAlign * RecordAlign;
+
+        struct alignas(RecordAlign) ChunkStorage {
+            ChunkStorage() noexcept {}   // leave the bytes uninitialised
+            std::byte bytes[ChunkBytes];
+        };
+
+        static mem::object_pool<ChunkStorage>& chunk_pool() {
+            static mem::object_pool<ChunkStorage> pool{ 16 };
+            return pool;
+        }
+
+        // ChunkBytes chunks go back to chunk_pool(); oversized ones (a single
+        // record larger than a chunk) to the heap
+        struct ChunkRelease {
+            std::size_t size = 0;
+            void operator()(std::byte* p) const noexcept {
+                if (size == ChunkBytes) chunk_pool().destroy(reinterpret_cast<ChunkStorage*>(p));
+                else ::operator delete(p, std::align_val_t{ RecordAlign });
             }
-            return true;
+        };
+
+        struct Chunk {
+            std::unique_ptr<std::byte, ChunkRelease> data;
+            std::size_t                              size = 0;
+            std::size_t                              used = 0;
+        };
+
+        static Chunk make_chunk(std::size_t size) {
+            std::byte* p = size == ChunkBytes
+                ? chunk_pool().create()->bytes
+                : static_cast<std::byte*>(::operator new(size, std::align_val_t{ RecordAlign }));
+            return { std::unique_ptr<std::byte, ChunkRelease>(p, ChunkRelease{ size }), size, 0 };
         }
 
-    private:
-        std::mutex mutex;
-        std::queue<RenderCommand> commands;
+        struct alignas(64) Lane {
+            std::mutex         lock;
+            std::vector<Chunk> chunks;   // recorded, in order
+            std::vector<Chunk> spare;    // drained, ready for reuse
+        };
+
+        static std::size_t lane_index() noexcept {
+            static std::atomic<std::size_t> next{ 0 };
+            thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % LaneCount;
+            return index;
+        }
+
+        Lane& my_lane() noexcept { return lanes[lane_index()]; }
+
+        static constexpr std::size_t stride_for(std::size_t payloadBytes) noexcept {
+            return HeaderBytes + (payloadBytes + RecordAlign - 1) / RecordAlign * RecordAlign;
+        }
+
+        // room for one record at the tail of the lane; nothing is published
+        // until commit(), so an abandoned reservation is simply reused
+        static std::byte* reserve(Lane& lane, std::size_t stride) {
+            if (lane.chunks.empty() || lane.chunks.back().size - lane.chunks.back().used < stride) {
+                if (stride <= ChunkBytes && !lane.spare.empty()) {
+                    lane.chunks.push_back(std::move(lane.spare.back()));
+                    lane.spare.pop_back();
+                }
+                else {
+                    const std::size_t size = stride <= ChunkBytes ? ChunkBytes : stride;
+                    lane.chunks.push_back(make_chunk(size));
+                }
+            }
+            auto& chunk = lane.chunks.back();
+            return chunk.data.get() + chunk.used;
+        }
+
+        static void commit(Lane& lane, std::byte* at, std::size_t stride,
+                           void (*invoke)(void*), void (*destroy)(void*)) noexcept {
+            new (at) Header{ invoke, destroy, static_cast<std::uint32_t>(stride) };
+            lane.chunks.back().used += stride;
+        }
+
+        static Header& header_at(std::byte* at) noexcept {
+            return *std::launder(reinterpret_cast<Header*>(at));
+        }
+
+        // replay every record in order; if one throws, the rest are still destroyed
+        static void run_all(std::vector<Chunk>& chunks) {
+            for (std::size_t ci = 0; ci < chunks.size(); ++ci) {
+                auto& c = chunks[ci];
+                for (std::size_t off = 0; off < c.used;) {
+                    Header& h = header_at(c.data.get() + off);
+                    void* payload = c.data.get() + off + HeaderBytes;
+                    const std::size_t stride = h.stride;
+                    try {
+                        h.invoke(payload);
+                    }
+                    catch (...) {
+                        destroy_from(chunks, ci, off);
+                        throw;
+                    }
+                    if (h.destroy) h.destroy(payload);
+                    off += stride;
+                }
+            }
+        }
+
+        static void destroy_from(std::vector<Chunk>& chunks, std::size_t ci, std::size_t off) noexcept {
+            for (; ci < chunks.size(); ++ci, off = 0) {
+                auto& c = chunks[ci];
+                for (; off < c.used;) {
+                    Header& h = header_at(c.data.get() + off);
+                    if (h.destroy) h.destroy(c.data.get() + off + HeaderBytes);
+                    off += h.stride;
+                }
+                c.used = 0;
+            }
+        }
+
+        static void destroy_all(std::vector<Chunk>& chunks) noexcept { destroy_from(chunks, 0, 0); }
+
+        std::array<Lane, LaneCount> lanes;
+        std::mutex                  drainMutex;
+        std::vector<Chunk>          replay;   // drain-side scratch, guarded by drainMutex
     };
 
 } // namespace almondshell::core
@@ -0,0 +1,497 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+// acoroutine.hpp
+#pragma once
+
+#include "aplatform.hpp"               // must always come first
+#include "aworkstealingscheduler.hpp"  // jobs::scheduler()
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Coroutine library.
+//
+//  ▸ coro::Task<T>       : lazy, awaitable, carries a result or exception;
+//                          awaiting hands control over by symmetric transfer
+//  ▸ when_all / when_any : fan-out / first-wins over child tasks
+//  ▸ CancellationSource  : cooperative cancellation, polled via tokens
+//  ▸ executors           : to_worker() / to_main_thread() hop threads;
+//                          main_thread_executor().run_pending() runs once per frame
+//  ▸ detach / sync_wait  : start a task from non-coroutine code
+//
+// almondnamespace::Task (aenginesystems.hpp) stays as the one-shot handle the
+// task graph resumes; coro::Task is for code that awaits results.
+
+namespace almondnamespace::coro {
+
+    // ─── Cancellation ────────────────────────────────────────────────
+    class OperationCancelled : public std::exception {
+    public:
+        const char* what() const noexcept override { return "operation cancelled"; }
+    };
+
+    class CancellationToken {
+    public:
+        CancellationToken() noexcept = default;   // never cancelled
+
+        bool can_be_cancelled() const noexcept { return state_ != nullptr; }
+        bool is_cancelled() const noexcept { return state_ && state_->load(std::memory_order_acquire); }
+        void throw_if_cancelled() const { if (is_cancelled()) throw OperationCancelled{}; }
+
+    private:
+        friend class CancellationSource;
+        explicit CancellationToken(std::shared_ptr<std::atomic<bool>> s) noexcept : state_{ std::move(s) } {}
+
+        std::shared_ptr<std::atomic<bool>> state_;
+    };
+
+    class CancellationSource {
+    public:
+        CancellationSource() : state_{ std::make_shared<std::atomic<bool>>(false) } {}
+
+        CancellationToken token() const noexcept { return CancellationToken{ state_ }; }
+        void cancel() noexcept { state_->store(true, std::memory_order_release); }
+        bool is_cancelled() const noexcept { return state_->load(std::memory_order_acquire); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> state_;
+    };
+
+    // ─── Task<T> ─────────────────────────────────────────────────────
+    template<typename T = void> class Task;
+
+    namespace _detail {
+        // on completion jump straight into whoever awaited us (no stack growth)
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+            template<typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+                if (auto c = h.promise().continuation) return c;
+                return std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        struct promise_base {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr      error;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            final_awaiter       final_suspend() const noexcept { return {}; }
+            void unhandled_exception() noexcept { error = std::current_exception(); }
+        };
+
+        template<typename T>
+        struct task_promise : promise_base {
+            std::optional<T> value;   // T need not be default-constructible
+
+            Task<T> get_return_object() noexcept;
+
+            template<typename U = T>
+                requires std::is_convertible_v<U&&, T>
+            void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+            T take() {
+                if (error) std::rethrow_exception(error);
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct task_promise<void> : promise_base {
+            Task<void> get_return_object() noexcept;
+            void return_void() noexcept {}
+            void take() { if (error) std::rethrow_exception(error); }
+        };
+    }
+
+    template<typename T>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = _detail::task_promise<T>;
+        using handle_t = std::coroutine_handle<promise_type>;
+        using value_type = T;
+
+        Task() noexcept = default;
+        explicit Task(handle_t h) noexcept : h_{ h } {}
+        Task(Task&& o) noexcept : h_{ std::exchange(o.h_, nullptr) } {}
+        Task& operator=(Task&& o) noexcept {
+            if (this != &o) {
+                if (h_) h_.destroy();
+                h_ = std::exchange(o.h_, nullptr);
+            }
+            return *this;
+        }
+        ~Task() { if (h_) h_.destroy(); }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        bool valid() const noexcept { return static_cast<bool>(h_); }
+        bool done()  const noexcept { return !h_ || h_.done(); }
+
+        struct awaiter {
+            handle_t h;
+
+            bool await_ready() const noexcept { return !h || h.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                h.promise().continuation = caller;
+                return h;   // start the child on this thread
+            }
+            T await_resume() {
+                assert(h && "awaiting an empty Task");
+                return h.promise().take();
+            }
+        };
+
+        // co_await task → runs it, resumes the caller with its result (or rethrows)
+        awaiter operator co_await() & noexcept { return { h_ }; }
+        awaiter operator co_await() && noexcept { return { h_ }; }
+
+        // completes with the task but leaves the result in place
+        auto when_ready() noexcept {
+            struct ready_awaiter : awaiter {
+                void await_resume() const noexcept {}
+            };
+            return ready_awaiter{ { h_ } };
+        }
+
+        // result of a finished task; rethrows what it threw
+        T result() {
+            assert(h_ && h_.done() && "Task::result() before completion");
+            return h_.promise().take();
+        }
+
+        handle_t handle() const noexcept { return h_; }
+
+    private:
+        handle_t h_;
+    };
+
+    namespace _detail {
+        template<typename T>
+        Task<T> task_promise<T>::get_return_object() noexcept {
+            return Task<T>{ std::coroutine_handle<task_promise<T>>::from_promise(*this) };
+        }
+
+        inline Task<void> task_promise<void>::get_return_object() noexcept {
+            return Task<void>{ std::coroutine_handle<task_promise<void>>::from_promise(*this) };
+        }
+
+        // self-destroying driver used to start tasks from plain code
+        struct detached_task {
+            struct promise_type {
+                detached_task get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+
+        template<typename T>
+        using result_or_monostate = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        template<typename T>
+        result_or_monostate<T> take_result(Task<T>& t) {
+            if constexpr (std::is_void_v<T>) { t.result(); return {}; }
+            else return t.result();
+        }
+    }
+
+    // ─── Executors ───────────────────────────────────────────────────
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+        virtual void post(std::coroutine_handle<> h) = 0;
+    };
+
+    // resumes on a job-system worker (inline if the scheduler is not running)
+    class WorkerExecutor final : public Executor {
+    public:
+        void post(std::coroutine_handle<> h) override {
+            jobs::scheduler().submit([h] { h.resume(); });
+        }
+    };
+
+    // resumes on whichever thread calls run_pending(), i.e. the main loop
+    class MainThreadExecutor final : public Executor {
+    public:
+        void post(std::coroutine_handle<> h) override {
+            std::scoped_lock lock(mutex_);
+            pending_.push_back(h);
+        }
+
+        // resumes everything posted so far; posts made meanwhile wait for the next call
+        std::size_t run_pending() {
+            {
+                std::scoped_lock lock(mutex_);
+                if (pending_.empty()) return 0;
+                running_.swap(pending_);
+            }
+            const std::size_t n = running_.size();
+            for (auto h : running_) h.resume();
+            running_.clear();
+            return n;
+        }
+
+    private:
+        std::mutex                           mutex_;
+        std::vector<std::coroutine_handle<>> pending_;
+        std::vector<std::coroutine_handle<>> running_;   // only touched by the main thread
+    };
+
+    inline WorkerExecutor& worker_executor() {
+        static WorkerExecutor e;
+        return e;
+    }
+
+    inline MainThreadExecutor& main_thread_executor() {
+        static MainThreadExecutor e;
+        return e;
+    }
+
+    // co_await ResumeOn{ ex } → continue on `ex`
+    struct ResumeOn {
+        Executor& executor;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) const { executor.post(h); }
+        void await_resume() const noexcept {}
+    };
+
+    inline ResumeOn to_worker() noexcept { return { worker_executor() }; }
+    inline ResumeOn to_main_thread() noexcept { return { main_thread_executor() }; }
+
+    // start `t` on `ex`
+    template<typename T>
+    Task<T> schedule_on(Executor& ex, Task<T> t) {
+        co_await ResumeOn{ ex };
+        co_return co_await std::move(t);
+    }
+
+    // run `t` wherever it runs, then hand its result back on `ex`
+    template<typename T>
+    Task<T> continue_on(Executor& ex, Task<T> t) {
+        if constexpr (std::is_void_v<T>) {
+            std::exception_ptr error;
+            try { co_await std::move(t); }
+            catch (...) { error = std::current_exception(); }
+            co_await ResumeOn{ ex };
+            if (error) std::rethrow_exception(error);
+        }
+        else {
+            co_await t.when_ready();
+            co_await ResumeOn{ ex };
+            co_return t.result();
+        }
+    }
+
+    // ─── Starting tasks from plain code ──────────────────────────────
+    // run `t` with nobody awaiting it; a failure is logged, not propagated
+    template<typename T>
+    void detach(Task<T> t) {
+        [](Task<T> task) -> _detail::detached_task {
+            try {
+                co_await std::move(task);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "[coro] Detached task failed: " << e.what() << "\n";
+            }
+            catch (...) {
+                std::cerr << "[coro] Detached task failed\n";
+            }
+        }(std::move(t));
+    }
+
+    // block the calling thread until `t` finishes. Never call it on the main
+    // thread for a task that hops to_main_thread(): nobody would run it
+    template<typename T>
+    T sync_wait(Task<T> t) {
+        std::mutex              m;
+        std::condition_variable cv;
+        bool                    finished = false;
+
+        [](Task<T>& task, std::mutex& mx, std::condition_variable& done, bool& flag) -> _detail::detached_task {
+            co_await task.when_ready();
+            std::scoped_lock lock(mx);   // notify under the lock: the waiter's locals outlive us
+            flag = true;
+            done.notify_one();
+        }(t, m, cv, finished);
+
+        std::unique_lock lock(m);
+        cv.wait(lock, [&] { return finished; });
+        return t.result();
+    }
+
+    // ─── when_all ────────────────────────────────────────────────────
+    namespace _detail {
+        // children + the awaiting parent; whoever arrives last resumes the parent
+        struct when_all_latch {
+            std::atomic<std::size_t> count;
+            std::coroutine_handle<>  waiter;
+
+            explicit when_all_latch(std::size_t children) noexcept : count{ children + 1 } {}
+            bool arrive() noexcept { return count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+        };
+
+        struct latch_awaiter {
+            when_all_latch& latch;
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> h) noexcept {
+                latch.waiter = h;
+                return !latch.arrive();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        template<typename T>
+        detached_task arrive_when_ready(Task<T>& t, when_all_latch& latch) {
+            co_await t.when_ready();
+            if (latch.arrive()) latch.waiter.resume();
+        }
+    }
+
+    // children start in order on the awaiting thread, each running until it
+    // first suspends; void results become std::monostate. Once every child
+    // is done, the first failure in argument order is rethrown.
+    template<typename... Ts>
+    Task<std::tuple<_detail::result_or_monostate<Ts>...>> when_all(Task<Ts>... tasks) {
+        _detail::when_all_latch latch{ sizeof...(Ts) };
+        (_detail::arrive_when_ready(tasks, latch), ...);
+        co_await _detail::latch_awaiter{ latch };
+        co_return std::tuple<_detail::result_or_monostate<Ts>...>{ _detail::take_result(tasks)... };
+    }
+
+    template<typename T>
+        requires (!std::is_void_v<T>)
+    Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+        _detail::when_all_latch latch{ tasks.size() };
+        for (auto& t : tasks) _detail::arrive_when_ready(t, latch);
+        co_await _detail::latch_awaiter{ latch };
+
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (auto& t : tasks) results.push_back(t.result());
+        co_return results;
+    }
+
+    inline Task<void> when_all(std::vector<Task<void>> tasks) {
+        _detail::when_all_latch latch{ tasks.size() };
+        for (auto& t : tasks) _detail::arrive_when_ready(t, latch);
+        co_await _detail::latch_awaiter{ latch };
+        for (auto& t : tasks) t.result();
+    }
+
+    // ─── when_any ────────────────────────────────────────────────────
+    template<typename T>
+    struct WhenAny {
+        std::size_t index = 0;
+        T           value;
+    };
+
+    template<>
+    struct WhenAny<void> {
+        std::size_t index = 0;
+    };
+
+    namespace _detail {
+        template<typename T>
+        struct when_any_state {
+            std::vector<Task<T>>     tasks;
+            CancellationSource       cancelOthers;
+            std::atomic<std::size_t> winner{ static_cast<std::size_t>(-1) };
+            when_all_latch           gate{ 1 };   // winner + parent
+
+            when_any_state(std::vector<Task<T>> ts, CancellationSource c)
+                : tasks{ std::move(ts) }, cancelOthers{ std::move(c) } {
+            }
+        };
+
+        // holds the state so losers may keep running after when_any returns
+        template<typename T>
+        detached_task race(std::shared_ptr<when_any_state<T>> s, std::size_t i) {
+            co_await s->tasks[i].when_ready();
+            auto none = static_cast<std::size_t>(-1);
+            if (s->winner.compare_exchange_strong(none, i, std::memory_order_acq_rel)) {
+                s->cancelOthers.cancel();
+                if (s->gate.arrive()) s->gate.waiter.resume();
+            }
+        }
+    }
+
+    // first child to finish wins (its failure is rethrown). `cancelOthers`
+    // is cancelled at that point; losers that watch its token stop early,
+    // the rest run to completion in the background.
+    template<typename T>
+    Task<WhenAny<T>> when_any(std::vector<Task<T>> tasks, CancellationSource cancelOthers = {}) {
+        if (tasks.empty()) throw std::invalid_argument("when_any: no tasks");
+
+        auto state = std::make_shared<_detail::when_any_state<T>>(std::move(tasks), std::move(cancelOthers));
+        for (std::size_t i = 0; i < state->tasks.size(); ++i) _detail::race(state, i);
+        co_await _detail::latch_awaiter{ state->gate };
+
+        const std::size_t i = state->winner.load(std::memory_order_acquire);
+        if constexpr (std::is_void_v<T>) {
+            state->tasks[i].result();
+            co_return WhenAny<void>{ i };
+        }
+        else {
+            co_return WhenAny<T>{ i, state->tasks[i].result() };
+        }
+    }
+
+    // ─── Common operations ───────────────────────────────────────────
+    // read a whole file on a worker; empty if it cannot be opened
+    inline Task<std::vector<std::byte>> read_file(std::string path, CancellationToken token = {}) {
+        co_await to_worker();
+        token.throw_if_cancelled();
+
+        std::vector<std::byte> buf;
+        std::ifstream in(path, std::ios::binary);
+        if (in) {
+            in.seekg(0, std::ios::end);
+            buf.resize(static_cast<size_t>(in.tellg()));
+            in.seekg(0);
+            in.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+        }
+        co_return buf;
+    }
+
+} // namespace almondnamespace::coro
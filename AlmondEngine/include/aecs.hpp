@@ -23,29 +23,81 @@
 #pragma once
 
 #include "aentitycomponentmanager.hpp"    // your ComponentStorage + add/get/has/remove
-#include "aeventsystem.hpp"         // events::push_event
+#include "aecsjournal.hpp"          // Journal, JournalRecord
+#include "aeventsystem.hpp"         // events::post
 #include "alogger.hpp"              // Logger, LogLevel
 #include "arobusttime.hpp"          // RobustTime
 #include "aentityhistory.hpp"
+#include "amemorytracker.hpp"      // MemTagScope
 
 #include <typeinfo>
 #include <string_view>
 #include <format>
 #include <utility>
 #include <vector>
+#include <tuple>
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
 #include <cassert>
+#include <stdexcept>
 
 namespace almondnamespace::ecs {
 
     using Entity = EntityID;  // alias for your EntityID
 
-    // ─── reg_ex: holds storage, ID counter, optional log/time ──────────────
+    // ─── compile‑time component list helpers ───────────────────────────────
+    template<typename C, typename... Cs>
+    inline constexpr bool contains_component_v = (std::is_same_v<C, Cs> || ...);
+
+    template<typename C, typename... Cs>
+    struct component_index;
+
+    template<typename C, typename... Rest>
+    struct component_index<C, C, Rest...> : std::integral_constant<std::size_t, 0> {};
+
+    template<typename C, typename First, typename... Rest>
+    struct component_index<C, First, Rest...>
+        : std::integral_constant<std::size_t, 1 + component_index<C, Rest...>::value> {};
+
+    template<typename C, typename... Cs>
+    inline constexpr std::size_t component_index_v = component_index<C, Cs...>::value;
+
+    template<typename... Cs>
+    inline constexpr bool unique_components_v = true;
+
+    template<typename C, typename... Rest>
+    inline constexpr bool unique_components_v<C, Rest...> =
+        !contains_component_v<C, Rest...> && unique_components_v<Rest...>;
+
+    // ─── EntitySlots: generation per dense index + recycled-index free list ─
+    struct EntitySlots {
+        std::vector<EntityGeneration> generation;  // current live generation per index
+        std::vector<EntityIndex>      free;        // destroyed indices, reused LIFO
+        std::size_t                   alive{ 0 };
+        std::uint64_t                 version{ 0 }; // bumped on every create/destroy
+    };
+
+    // ─── reg_ex: holds storage, entity slots, optional log/time ────────────
+    //   reg_ex<>        : erased ComponentStorage, any component type accepted
+    //   reg_ex<Cs...>   : std::tuple of ComponentPool<Cs>..., resolved at
+    //                     compile time; using a type outside Cs is an error
     template<typename... Cs>
     struct reg_ex {
-        ComponentStorage   storage;    // your erased MPMC‑backed storage
-        EntityID           nextID{ 1 };  // simple entity ID generator
+        static_assert(unique_components_v<Cs...>, "reg_ex<Cs...> lists a component type twice");
+
+        static constexpr bool typed = sizeof...(Cs) > 0;
+        using storage_type = std::conditional_t<typed,
+            std::tuple<ComponentPool<Cs>...>,
+            ComponentStorage>;
+
+        storage_type       storage;    // sparse‑set pools, one per component type
+        EntitySlots        slots{};      // index/generation allocator
         Logger* log{ nullptr };
         time::Timer* clk{ nullptr };
+        std::uint64_t      tick{ 1 };    // bumped by advance_tick; stamps journal records and component writes (0 = "before anything")
+        Journal            journal{};    // structural change records, drained by flush_journal
     };
 
     // helper to construct with optional Logger/Clock
@@ -54,85 +106,314 @@ namespace almondnamespace::ecs {
         Logger* L = nullptr,
         time::Timer* C = nullptr)
     {
-        return { {}, 1, L, C };
+        reg_ex<Cs...> R{};
+        R.log = L;
+        R.clk = C;
+        return R;
+    }
+
+    // ─── pool access: constant tuple index when typed, one hash otherwise ─
+    template<typename C, typename... Cs>
+    [[nodiscard]] inline ComponentPool<C>& pool(reg_ex<Cs...>& R) {
+        if constexpr (reg_ex<Cs...>::typed) {
+            static_assert(contains_component_v<C, Cs...>,
+                "component type is not part of this reg_ex<Cs...>");
+            return std::get<component_index_v<C, Cs...>>(R.storage);
+        }
+        else {
+            return R.storage.template pool<C>();
+        }
+    }
+
+    // nullptr when an erased registry has never seen a C
+    template<typename C, typename... Cs>
+    [[nodiscard]] inline const ComponentPool<C>* find_pool(const reg_ex<Cs...>& R) noexcept {
+        if constexpr (reg_ex<Cs...>::typed) {
+            static_assert(contains_component_v<C, Cs...>,
+                "component type is not part of this reg_ex<Cs...>");
+            return &std::get<component_index_v<C, Cs...>>(R.storage);
+        }
+        else {
+            return R.storage.template find_pool<C>();
+        }
+    }
+
+    template<typename C, typename... Cs>
+    [[nodiscard]] inline ComponentPool<C>* find_pool(reg_ex<Cs...>& R) noexcept {
+        return const_cast<ComponentPool<C>*>(find_pool<C>(std::as_const(R)));
+    }
+
+    // advance the registry clock (call once per simulation tick)
+    template<typename... Cs>
+    inline std::uint64_t advance_tick(reg_ex<Cs...>& R) noexcept {
+        return ++R.tick;
     }
 
     namespace _detail {
         template<typename... Cs>
         inline void notify(reg_ex<Cs...>& R,
-            std::string_view action,
+            JournalOp op,
             Entity e,
-            std::string_view comp = "")
+            ComponentTypeID comp = no_component) noexcept
         {
-            if (!R.log || !R.clk) return;
-            auto ts = time::getCurrentTimeString();
-            R.log->log(std::format("[ECS] {}{} entity={} at {}",
-                action,
-                comp.empty() ? "" : std::format(":{}", comp),
-                e, ts));
-            events::push_event(events::Event{
-                events::EventType::Custom,
-                { {"ecs_action", std::string(action)},
-                  {"entity",     std::to_string(e)},
-                  {"component",  std::string(comp)},
-                  {"time",       ts} },
-                0.f, 0.f });
+            R.journal.record(op, e, comp, R.tick);
         }
     }
 
     // ─── CRUD API ───────────────────────────────────────────────────────────
 
-    // create a new entity ID
+    // O(1): the handle's generation still matches its slot
+    template<typename... Cs>
+    [[nodiscard]] inline bool is_alive(const reg_ex<Cs...>& R, Entity e) noexcept {
+        const auto index = entity_index(e);
+        const auto gen = entity_generation(e);
+        return gen != 0
+            && index < R.slots.generation.size()
+            && R.slots.generation[index] == gen;
+    }
+
+    template<typename... Cs>
+    [[nodiscard]] inline std::size_t alive_count(const reg_ex<Cs...>& R) noexcept {
+        return R.slots.alive;
+    }
+
+    // create a new entity, reusing a destroyed index when one is free
     template<typename... Cs>
     inline Entity create_entity(reg_ex<Cs...>& R) {
-        Entity e = R.nextID++;
-        _detail::notify(R, "createEntity", e);
+        auto& S = R.slots;
+        EntityIndex index;
+        if (!S.free.empty()) {
+            index = S.free.back();
+            S.free.pop_back();
+        }
+        else {
+            assert(S.generation.size() < std::numeric_limits<EntityIndex>::max() && "entity index space exhausted");
+            index = static_cast<EntityIndex>(S.generation.size());
+            S.generation.push_back(1);
+        }
+        ++S.alive;
+        ++S.version;
+
+        const Entity e = make_entity(index, S.generation[index]);
+        _detail::notify(R, JournalOp::CreateEntity, e);
         return e;
     }
 
-    // destroy: erase all components for that entity
+    template<typename... Cs>
+    inline std::vector<Entity> create_entities(reg_ex<Cs...>& R, std::size_t n) {
+        std::vector<Entity> out;
+        out.reserve(n);
+        const std::size_t recycled = std::min(n, R.slots.free.size());
+        R.slots.generation.reserve(R.slots.generation.size() + (n - recycled));
+        for (std::size_t i = 0; i < n; ++i) out.push_back(create_entity(R));
+        return out;
+    }
+
+    // destroy: erase all components for that entity and retire its handle;
+    // stale or already-destroyed handles are ignored
     template<typename... Cs>
     inline void destroy_entity(reg_ex<Cs...>& R, Entity e) {
-        // erase all types in Cs...
-        (remove_component<Cs>(R, e), ...);
-        _detail::notify(R, "destroyEntity", e);
+        if (!is_alive(R, e)) return;
+
+        if constexpr (reg_ex<Cs...>::typed) {
+            (std::get<ComponentPool<Cs>>(R.storage).remove(e), ...);
+        }
+        else {
+            R.storage.remove_all(e);
+        }
+
+        auto& S = R.slots;
+        const auto index = entity_index(e);
+        // a slot whose generation would wrap is retired instead of recycled
+        if (++S.generation[index] != 0) S.free.push_back(index);
+        --S.alive;
+        ++S.version;
+
+        _detail::notify(R, JournalOp::DestroyEntity, e);
     }
 
-    // add a component of type C
+    template<typename... Cs>
+    inline void destroy_entities(reg_ex<Cs...>& R, std::span<const Entity> es) {
+        R.slots.free.reserve(R.slots.free.size() + es.size());
+        for (const Entity e : es) destroy_entity(R, e);
+    }
+
+    namespace _detail {
+        // references cannot be "empty": a dead handle here is a caller bug
+        template<typename... Cs>
+        inline void require_alive(const reg_ex<Cs...>& R, Entity e, const char* what) {
+            if (is_alive(R, e)) return;
+            assert(false && "ECS access through a dead entity handle");
+            throw std::invalid_argument(what);
+        }
+    }
+
+    // add a component of type C; false (and nothing stored) for a dead handle,
+    // which would otherwise clobber whichever generation now owns the index
     template<typename C, typename... Cs>
-    inline void add_component(reg_ex<Cs...>& R, Entity e, C c) {
-        ::almondnamespace::ecs::add_component<C>(R.storage, e, std::move(c));
-        _detail::notify(R, "addComponent", e, typeid(C).name());
+    inline bool add_component(reg_ex<Cs...>& R, Entity e, C c) {
+        if (!is_alive(R, e)) return false;
+        mem::MemTagScope memTag(mem::MemTag::ECS);
+        pool<C>(R).emplace_at(R.tick, e, std::move(c));
+        _detail::notify(R, JournalOp::AddComponent, e, component_id<C>());
+        return true;
     }
 
     // remove component C
     template<typename C, typename... Cs>
     inline void remove_component(reg_ex<Cs...>& R, Entity e) {
-        ::almondnamespace::ecs::remove_component<C>(R.storage, e);
-        _detail::notify(R, "removeComponent", e, typeid(C).name());
+        if (auto* p = find_pool<C>(R)) p->remove(e);
+        _detail::notify(R, JournalOp::RemoveComponent, e, component_id<C>());
     }
 
     // test for component C
     template<typename C, typename... Cs>
     [[nodiscard]] inline bool has_component(const reg_ex<Cs...>& R, Entity e) {
-        return ::almondnamespace::ecs::has_component<C>(R.storage, e);
+        auto* p = find_pool<C>(R);
+        return p && p->contains(e);
     }
 
-    // get mutable reference to component C
+    // get mutable reference to component C; stamps it as changed this tick
     template<typename C, typename... Cs>
     [[nodiscard]] inline C& get_component(reg_ex<Cs...>& R, Entity e) {
-        return ::almondnamespace::ecs::get_component<C>(R.storage, e);
+        _detail::require_alive(R, e, "get_component: dead entity");
+        auto& p = pool<C>(R);
+        p.touch(e, R.tick);
+        return p.get(e);
+    }
+
+    // read-only access, no change stamp
+    template<typename C, typename... Cs>
+    [[nodiscard]] inline const C& get_component(const reg_ex<Cs...>& R, Entity e) {
+        _detail::require_alive(R, e, "get_component: dead entity");
+        auto* p = find_pool<C>(R);
+        assert(p && "Component not found!");
+        return p->get(e);
+    }
+
+    // ─── access tags ────────────────────────────────────────────────────────
+    // view<Write<C>> hands out C& and stamps it changed; a plain C (or
+    // Read<C>) is handed out as const C&. Systems declare access with the
+    // same tags (aecsparallel.hpp).
+    template<typename... Ts> struct Read {};
+    template<typename... Ts> struct Write {};
+
+    namespace _detail {
+        template<typename V>
+        struct view_arg {
+            using component = std::remove_const_t<V>;
+            using reference = const component&;
+            static constexpr bool writes = false;
+        };
+        template<typename C>
+        struct view_arg<Read<C>> : view_arg<C> {};
+        template<typename C>
+        struct view_arg<Write<C>> {
+            using component = C;
+            using reference = C&;
+            static constexpr bool writes = true;
+        };
+
+        template<typename V>
+        using view_component_t = typename view_arg<V>::component;
+
+        // the pool a view argument reads from
+        template<typename V>
+        using view_pool_t = ComponentPool<view_component_t<V>>;
+
+        // hand out a reference for each view argument, stamping only Write<C>
+        template<typename V, typename... Cs>
+        inline typename view_arg<V>::reference view_fetch(reg_ex<Cs...>& R, view_pool_t<V>* p, Entity e) {
+            const auto i = p->index_of(e);
+            if constexpr (view_arg<V>::writes) p->touch_slot(i, R.tick);
+            return p->data()[i];
+        }
     }
 
     // iterate over entities that have all Vs…
+    //   view<Velocity, Write<Position>> : Position is stamped changed, Velocity is not
+    // The walk runs over a span of the smallest pool's entity array. fn may
+    // remove components of the entity it is handed, but must not add to any
+    // viewed pool (that can reallocate the span under the loop): record such
+    // changes in a CommandBuffer (aecscommandbuffer.hpp) and apply it after.
     template<typename... Vs, typename... Cs, typename Fn>
     inline void view(reg_ex<Cs...>& R, Fn&& fn) {
-        // brute‑force: scan storage for first type, test others
-        for (auto& [ent, compMap] : R.storage) {
-            if ((has_component<Vs>(R, ent) && ...)) {
-                fn(ent, get_component<Vs>(R, ent)...);
+        static_assert(sizeof...(Vs) > 0, "view needs at least one component type");
+
+        auto pools = std::make_tuple(find_pool<_detail::view_component_t<Vs>>(R)...);
+        if (!(std::get<_detail::view_pool_t<Vs>*>(pools) && ...)) return;
+
+        // drive the walk from the smallest pool, probe the rest by sparse lookup
+        const IComponentPool* lead = nullptr;
+        ((lead = (!lead || std::get<_detail::view_pool_t<Vs>*>(pools)->size() < lead->size())
+            ? std::get<_detail::view_pool_t<Vs>*>(pools) : lead), ...);
+
+        // walk backwards so fn may remove the current entity's components
+        auto ents = lead->entities();
+        for (std::size_t i = ents.size(); i-- > 0; ) {
+            const Entity ent = ents[i];
+            if ((std::get<_detail::view_pool_t<Vs>*>(pools)->contains(ent) && ...)) {
+                fn(ent, _detail::view_fetch<Vs>(R, std::get<_detail::view_pool_t<Vs>*>(pools), ent)...);
+                assert(lead->size() <= ents.size() && "view: fn grew the pool being walked; defer adds through a CommandBuffer");
             }
         }
     }
 
+    // ─── change queries: only the slots stamped after sinceTick ────────────
+    // fn(Entity, const C&). Remember R.tick after a pass and feed it back next
+    // time to see just what was added/written in between.
+
+    template<typename C, typename... Cs, typename Fn>
+    inline void view_changed(const reg_ex<Cs...>& R, std::uint64_t sinceTick, Fn&& fn) {
+        auto* p = find_pool<C>(R);
+        if (!p) return;
+        auto ents = p->entities();
+        auto ticks = p->changed_ticks();
+        auto data = p->data();
+        for (std::size_t i = 0; i < ents.size(); ++i)
+            if (ticks[i] > sinceTick) fn(ents[i], data[i]);
+    }
+
+    template<typename C, typename... Cs, typename Fn>
+    inline void view_added(const reg_ex<Cs...>& R, std::uint64_t sinceTick, Fn&& fn) {
+        auto* p = find_pool<C>(R);
+        if (!p) return;
+        auto ents = p->entities();
+        auto ticks = p->added_ticks();
+        auto data = p->data();
+        for (std::size_t i = 0; i < ents.size(); ++i)
+            if (ticks[i] > sinceTick) fn(ents[i], data[i]);
+    }
+
+    // ─── Journal consumers (cold path) ──────────────────────────────────────
+
+    // drain pending journal records into fn(const JournalRecord&)
+    template<typename... Cs, typename Fn>
+    inline std::size_t drain_journal(reg_ex<Cs...>& R, Fn&& fn) {
+        return R.journal.drain(std::forward<Fn>(fn));
+    }
+
+    // drain the journal into R.log and, with emitEvents, the typed event bus
+    // once per frame; subscribers receive the JournalRecord itself via
+    // events::subscribe. Opt-in: the channel grows until someone pumps it.
+    template<typename... Cs>
+    inline std::size_t flush_journal(reg_ex<Cs...>& R, bool emitEvents = false) {
+        if (!R.log && !emitEvents) {
+            const std::size_t n = R.journal.size();
+            R.journal.clear();
+            return n;
+        }
+        const std::string ts = R.log ? time::getCurrentTimeString() : std::string{};
+        return R.journal.drain([&](const JournalRecord& r) {
+            if (R.log) {
+                const std::string_view comp = r.component == no_component ? "" : component_name(r.component);
+                R.log->log(std::format("[ECS] {}{} entity={} tick={} at {}",
+                    journal_op_to_string(r.op),
+                    comp.empty() ? "" : std::format(":{}", comp),
+                    r.entity, r.tick, ts));
+            }
+            if (emitEvents) events::post(r);
+        });
+    }
+
 } // namespace almondnamespace::ecs
\ No newline at end of file
@@ -0,0 +1,256 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aecscommandbuffer.hpp
+#pragma once
+
+#include "aplatform.hpp"              // must always come first
+
+#include "aecs.hpp"                   // reg_ex, create_entities, add/remove_component
+#include "aworkstealingscheduler.hpp" // jobs::scheduler().worker_index()
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace almondnamespace::ecs
+{
+    // ─── CommandBuffer ──────────────────────────────────────────────────────
+    // Records structural changes while a system iterates; nothing touches the
+    // registry until apply(). create() hands out a provisional handle
+    // (generation 0) that add/remove/destroy in the same buffer accept and
+    // that apply() maps to a real entity.
+    //
+    // Apply order:
+    //   1. creates, allocated in one go
+    //   2. per component type (by ComponentTypeID): adds and removes sorted
+    //      by entity index; for one entity only its last recorded op for
+    //      that type takes effect (remove-then-add leaves it added)
+    //   3. destroys — a destroy always wins over anything else in the batch
+    template<typename... Cs>
+    class CommandBuffer {
+    public:
+        using registry_type = reg_ex<Cs...>;
+
+        CommandBuffer() = default;
+        CommandBuffer(CommandBuffer&&) noexcept = default;
+        CommandBuffer& operator=(CommandBuffer&&) noexcept = default;
+
+        [[nodiscard]] Entity create() {
+            ++pendingCreates_;
+            return make_entity(static_cast<EntityIndex>(pendingCreates_), 0);
+        }
+
+        void destroy(Entity e) { destroys_.push_back(e); }
+
+        template<typename C>
+        void add(Entity e, C c) {
+            stage<C>().ops.emplace_back(e, std::optional<C>(std::move(c)));
+        }
+
+        template<typename C>
+        void remove(Entity e) {
+            stage<C>().ops.emplace_back(e, std::nullopt);
+        }
+
+        [[nodiscard]] static bool is_provisional(Entity e) noexcept {
+            return entity_generation(e) == 0 && entity_index(e) != 0;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            std::size_t n = pendingCreates_ + destroys_.size();
+            for (auto& s : stages_) if (s) n += s->size();
+            return n;
+        }
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        void clear() noexcept {
+            pendingCreates_ = 0;
+            created_.clear();
+            destroys_.clear();
+            for (auto& s : stages_) if (s) s->clear();
+        }
+
+        // play this buffer back on its own
+        void apply(registry_type& R) {
+            begin_apply(R);
+            for (ComponentTypeID id = 0; id < stages_.size(); ++id) apply_stage(R, id);
+            std::vector<Entity> doomed;
+            collect_destroys(doomed);
+            finish_destroys(R, doomed);
+            clear();
+        }
+
+        // ── phases, driven by apply() or CommandBuffers::apply() ────────────
+
+        void begin_apply(registry_type& R) {
+            created_ = create_entities(R, pendingCreates_);
+        }
+
+        void apply_stage(registry_type& R, ComponentTypeID id) {
+            if (id < stages_.size() && stages_[id]) stages_[id]->apply(R, *this);
+        }
+
+        void collect_destroys(std::vector<Entity>& out) const {
+            for (auto e : destroys_) out.push_back(resolve(e));
+        }
+
+        static void finish_destroys(registry_type& R, std::vector<Entity>& doomed) {
+            std::sort(doomed.begin(), doomed.end(), [](Entity a, Entity b) {
+                return entity_index(a) != entity_index(b) ? entity_index(a) < entity_index(b) : a < b;
+            });
+            doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+            destroy_entities(R, std::span<const Entity>(doomed));
+        }
+
+        [[nodiscard]] std::size_t stage_count() const noexcept { return stages_.size(); }
+
+        [[nodiscard]] Entity resolve(Entity e) const noexcept {
+            if (!is_provisional(e)) return e;
+            const auto i = entity_index(e) - 1;
+            assert(i < created_.size() && "provisional entity resolved before begin_apply");
+            return created_[i];
+        }
+
+    private:
+        struct StageBase {
+            virtual ~StageBase() = default;
+            virtual void        apply(registry_type& R, const CommandBuffer& cb) = 0;
+            virtual std::size_t size() const noexcept = 0;
+            virtual void        clear() noexcept = 0;
+        };
+
+        template<typename C>
+        struct Stage final : StageBase {
+            // add carries a value, remove is nullopt; kept in recorded order
+            std::vector<std::pair<Entity, std::optional<C>>> ops;
+
+            void apply(registry_type& R, const CommandBuffer& cb) override {
+                if (ops.empty()) return;
+                for (auto& op : ops) op.first = cb.resolve(op.first);
+                // sorted by index: dense pool writes and sparse pages in order;
+                // stable, so each handle's ops stay in recorded order and the
+                // last of a run is the one that counts
+                std::stable_sort(ops.begin(), ops.end(), [](auto& a, auto& b) {
+                    return entity_index(a.first) != entity_index(b.first)
+                        ? entity_index(a.first) < entity_index(b.first) : a.first < b.first;
+                });
+                pool<C>(R).reserve(pool<C>(R).size() + ops.size());
+                for (std::size_t i = 0; i < ops.size(); ++i) {
+                    if (i + 1 < ops.size() && ops[i + 1].first == ops[i].first) continue;   // superseded
+                    auto& [e, c] = ops[i];
+                    if (c) add_component<C>(R, e, std::move(*c));   // no-op for a dead handle
+                    else   remove_component<C>(R, e);
+                }
+                ops.clear();
+            }
+
+            std::size_t size() const noexcept override { return ops.size(); }
+            void clear() noexcept override { ops.clear(); }
+        };
+
+        template<typename C>
+        Stage<C>& stage() {
+            const auto id = component_id<C>();
+            if (id >= stages_.size()) stages_.resize(static_cast<std::size_t>(id) + 1);
+            if (!stages_[id]) stages_[id] = std::make_unique<Stage<C>>();
+            return static_cast<Stage<C>&>(*stages_[id]);
+        }
+
+        std::size_t                             pendingCreates_{ 0 };
+        std::vector<Entity>                     created_;
+        std::vector<Entity>                     destroys_;
+        std::vector<std::unique_ptr<StageBase>> stages_;   // indexed by ComponentTypeID
+    };
+
+    // ─── CommandBuffers: one CommandBuffer per worker thread ────────────────
+    // local() picks the calling thread's buffer without locking: slot 0 is
+    // for threads outside the worker pool (the thread driving the frame),
+    // slot w+1 for jobs::scheduler() worker w. Slots are sized from the
+    // scheduler's worker count at construction; workers beyond that (the
+    // scheduler started or was restarted with more threads later) get a
+    // buffer from a locked side table, folded into the fast slots at the
+    // next apply(). apply() at the sync point merges all of them phase by
+    // phase, in slot order.
+    template<typename... Cs>
+    class CommandBuffers {
+    public:
+        using buffer_type = CommandBuffer<Cs...>;
+
+        CommandBuffers()
+            : buffers_(jobs::scheduler().worker_count() + 1) {
+        }
+
+        [[nodiscard]] buffer_type& local() {
+            const auto slot = static_cast<std::size_t>(jobs::scheduler().worker_index() + 1);
+            if (slot < buffers_.size()) return buffers_[slot];
+            std::lock_guard lock(overflowLock_);
+            return overflow_[slot];   // map nodes are stable: the reference outlives the lock
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            std::size_t n = 0;
+            for (auto& b : buffers_) n += b.size();
+            std::lock_guard lock(overflowLock_);
+            for (auto& [slot, b] : overflow_) n += b.size();
+            return n;
+        }
+
+        void apply(reg_ex<Cs...>& R) {
+            // overflow slots all sit past buffers_, so this is still slot order
+            std::vector<buffer_type*> all;
+            all.reserve(buffers_.size() + overflow_.size());
+            for (auto& b : buffers_) all.push_back(&b);
+            for (auto& [slot, b] : overflow_) all.push_back(&b);
+
+            std::size_t stages = 0;
+            for (auto* b : all) {
+                b->begin_apply(R);
+                stages = std::max(stages, b->stage_count());
+            }
+            for (ComponentTypeID id = 0; id < stages; ++id)
+                for (auto* b : all) b->apply_stage(R, id);
+
+            std::vector<Entity> doomed;
+            for (auto* b : all) b->collect_destroys(doomed);
+            buffer_type::finish_destroys(R, doomed);
+
+            for (auto* b : all) b->clear();
+
+            // grow once so those workers take the lock-free path from now on
+            if (!overflow_.empty()) {
+                buffers_.resize(overflow_.rbegin()->first + 1);
+                overflow_.clear();
+            }
+        }
+
+    private:
+        std::vector<buffer_type>                buffers_;
+        mutable std::mutex                      overflowLock_;
+        std::map<std::size_t, buffer_type>      overflow_;   // slot -> buffer, under overflowLock_
+    };
+
+} // namespace almondnamespace::ecs
@@ -0,0 +1,112 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aecsjournal.hpp
+#pragma once
+
+#include "aplatform.hpp"                 // must always come first
+
+#include "aentitycomponentmanager.hpp"   // EntityID, ComponentTypeID
+
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace almondnamespace::ecs
+{
+    // ─── Journal records ────────────────────────────────────────────────────
+    enum class JournalOp : std::uint8_t {
+        CreateEntity,
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent,
+        ModifyComponent
+    };
+
+    [[nodiscard]] constexpr std::string_view journal_op_to_string(JournalOp op) noexcept {
+        switch (op) {
+        case JournalOp::CreateEntity:    return "createEntity";
+        case JournalOp::DestroyEntity:   return "destroyEntity";
+        case JournalOp::AddComponent:    return "addComponent";
+        case JournalOp::RemoveComponent: return "removeComponent";
+        case JournalOp::ModifyComponent: return "modifyComponent";
+        default:                         return "unknown";
+        }
+    }
+
+    struct JournalRecord {
+        std::uint64_t   tick{ 0 };
+        EntityID        entity{ 0 };
+        ComponentTypeID component{ no_component };
+        JournalOp       op{ JournalOp::CreateEntity };
+    };
+    static_assert(std::is_trivially_copyable_v<JournalRecord>, "JournalRecord must stay POD");
+
+    // ─── Journal : fixed‑capacity ring of change records ────────────────────
+    // Written by the thread that owns the registry; drained once per frame by
+    // whatever consumer cares (logging, events, replication). When the ring
+    // is full the oldest record is overwritten and counted in dropped().
+    class Journal {
+    public:
+        static constexpr std::size_t default_capacity = 4096;
+
+        explicit Journal(std::size_t capacity = default_capacity)
+            : buf_(capacity), mask_(capacity - 1) {
+            assert(capacity > 0 && (capacity & mask_) == 0 && "capacity must be a power of two");
+        }
+
+        void record(JournalOp op, EntityID e, ComponentTypeID c, std::uint64_t tick) noexcept {
+            if (!enabled) return;
+            if (head_ - tail_ == buf_.size()) {
+                ++tail_;
+                ++dropped_;
+            }
+            buf_[head_++ & mask_] = JournalRecord{ tick, e, c, op };
+        }
+
+        /// hand every pending record to fn in order, then forget them
+        template<typename Fn>
+        std::size_t drain(Fn&& fn) {
+            const std::size_t n = head_ - tail_;
+            for (; tail_ != head_; ++tail_)
+                fn(static_cast<const JournalRecord&>(buf_[tail_ & mask_]));
+            return n;
+        }
+
+        void clear() noexcept { tail_ = head_; }
+
+        [[nodiscard]] std::size_t size()     const noexcept { return head_ - tail_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return buf_.size(); }
+        [[nodiscard]] std::size_t dropped()  const noexcept { return dropped_; }
+
+        bool enabled = true;
+
+    private:
+        std::vector<JournalRecord> buf_;
+        std::size_t                mask_;
+        std::size_t                head_ = 0;
+        std::size_t                tail_ = 0;
+        std::size_t                dropped_ = 0;
+    };
+
+} // namespace almondnamespace::ecs
@@ -0,0 +1,160 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aecsparallel.hpp
+#pragma once
+
+#include "aplatform.hpp"               // must always come first
+
+#include "aecs.hpp"                    // reg_ex, pools, view
+#include "aworkstealingscheduler.hpp"  // jobs::parallel_for
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace almondnamespace::ecs
+{
+    // ─── parallel_view ──────────────────────────────────────────────────────
+    // Like view<Vs...>, but the lead pool's dense range is cut into `grain`
+    // entity chunks that run across the worker pool (the caller takes part
+    // and steals back work while it waits). fn must only touch the
+    // components it is handed; no structural changes during the pass —
+    // record them in a CommandBuffer and apply it afterwards.
+    template<typename... Vs, typename... Cs, typename Fn>
+    inline void parallel_view(reg_ex<Cs...>& R, Fn&& fn, std::size_t grain = 256) {
+        static_assert(sizeof...(Vs) > 0, "parallel_view needs at least one component type");
+
+        auto pools = std::make_tuple(find_pool<_detail::view_component_t<Vs>>(R)...);
+        if (!(std::get<_detail::view_pool_t<Vs>*>(pools) && ...)) return;
+
+        const IComponentPool* lead = nullptr;
+        ((lead = (!lead || std::get<_detail::view_pool_t<Vs>*>(pools)->size() < lead->size())
+            ? std::get<_detail::view_pool_t<Vs>*>(pools) : lead), ...);
+
+        auto ents = lead->entities();
+        jobs::parallel_for(0, ents.size(), grain, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                const Entity ent = ents[i];
+                if ((std::get<_detail::view_pool_t<Vs>*>(pools)->contains(ent) && ...)) {
+                    fn(ent, _detail::view_fetch<Vs>(R, std::get<_detail::view_pool_t<Vs>*>(pools), ent)...);
+                }
+            }
+        });
+        assert(lead->size() == ents.size() && "parallel_view: fn changed the pool being walked; defer through a CommandBuffer");
+    }
+
+    // ─── system access declarations ────────────────────────────────────────
+    // Read<Ts...> / Write<Ts...> come from aecs.hpp, where view uses them too
+
+    struct SystemDesc {
+        std::string                  name;
+        std::vector<std::type_index> reads;
+        std::vector<std::type_index> writes;
+        std::function<void()>        run;
+    };
+
+    [[nodiscard]] inline bool conflicts(const SystemDesc& a, const SystemDesc& b) noexcept {
+        auto overlaps = [](const std::vector<std::type_index>& x, const std::vector<std::type_index>& y) {
+            for (auto& t : x)
+                if (std::find(y.begin(), y.end(), t) != y.end()) return true;
+            return false;
+        };
+        return overlaps(a.writes, b.writes)
+            || overlaps(a.writes, b.reads)
+            || overlaps(a.reads, b.writes);
+    }
+
+    // ─── SystemGraph ────────────────────────────────────────────────────────
+    // Systems are added in tick order. A later system depends on every earlier
+    // one it conflicts with; build() levels the DAG and run() executes each
+    // level concurrently on the worker pool.
+    class SystemGraph {
+    public:
+        template<typename... Rs, typename... Ws, typename Fn>
+        std::size_t add_system(std::string name, Read<Rs...>, Write<Ws...>, Fn&& fn) {
+            systems_.push_back(SystemDesc{
+                std::move(name),
+                { std::type_index(typeid(Rs))... },
+                { std::type_index(typeid(Ws))... },
+                std::function<void()>(std::forward<Fn>(fn)) });
+            built_ = false;
+            return systems_.size() - 1;
+        }
+
+        void build() {
+            const std::size_t n = systems_.size();
+            deps_.assign(n, {});
+            std::vector<std::size_t> level(n, 0);
+            std::size_t maxLevel = 0;
+
+            for (std::size_t j = 0; j < n; ++j) {
+                for (std::size_t i = 0; i < j; ++i) {
+                    if (conflicts(systems_[i], systems_[j])) {
+                        deps_[j].push_back(i);
+                        level[j] = std::max(level[j], level[i] + 1);
+                    }
+                }
+                maxLevel = std::max(maxLevel, level[j]);
+            }
+
+            levels_.assign(n ? maxLevel + 1 : 0, {});
+            for (std::size_t j = 0; j < n; ++j)
+                levels_[level[j]].push_back(j);
+            built_ = true;
+        }
+
+        void run() {
+            if (!built_) build();
+            for (auto& lvl : levels_) {
+                jobs::parallel_for(0, lvl.size(), 1, [&](std::size_t b, std::size_t e) {
+                    for (std::size_t i = b; i < e; ++i) systems_[lvl[i]].run();
+                });
+            }
+        }
+
+        [[nodiscard]] const std::vector<std::vector<std::size_t>>& levels() const noexcept { return levels_; }
+        [[nodiscard]] const std::vector<SystemDesc>& systems() const noexcept { return systems_; }
+
+        void dump_dot(const std::string& path = "systems.dot") {
+            if (!built_) build();
+            std::ofstream out(path);
+            out << "digraph Systems {\n";
+            for (std::size_t j = 0; j < systems_.size(); ++j) {
+                out << "  S" << j << " [label=\"" << systems_[j].name << "\"];\n";
+                for (auto i : deps_[j]) out << "  S" << i << " -> S" << j << ";\n";
+            }
+            out << "}\n";
+        }
+
+    private:
+        std::vector<SystemDesc>               systems_;
+        std::vector<std::vector<std::size_t>> deps_;
+        std::vector<std::vector<std::size_t>> levels_;
+        bool                                  built_ = false;
+    };
+
+} // namespace almondnamespace::ecs
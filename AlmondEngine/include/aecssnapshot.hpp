@@ -0,0 +1,213 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aecssnapshot.hpp
+#pragma once
+
+#include "aplatform.hpp"   // must always come first
+
+#include "aecs.hpp"        // reg_ex, ComponentPool, EntitySlots
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace almondnamespace::ecs
+{
+    // ─── Snapshot<Cs...> ────────────────────────────────────────────────────
+    // A frozen copy of a typed registry built from immutable, ref‑counted
+    // chunks of snapshot_chunk_size dense slots. take_snapshot() given the
+    // previous snapshot of the same registry re‑shares every chunk whose
+    // ComponentPool chunk revision is unchanged: that is one integer compare
+    // per chunk, no slot is looked at. A per‑frame snapshot costs O(chunks)
+    // plus a copy of each *changed* chunk, and two snapshots diff by pointer
+    // comparison.
+    //
+    // Revisions move on add/remove and on writes that stamp the slot
+    // (get_component, view<Write<C>>, add_component). take_snapshot still
+    // advances R.tick so view_changed can tell writes after it apart.
+    template<typename C>
+    inline constexpr std::size_t snapshot_chunk_size = ComponentPool<C>::chunk_size;
+
+    template<typename C>
+    struct SnapshotChunk {
+        std::vector<Entity> entities;
+        std::vector<C>      data;
+        std::uint64_t       revision{ 0 };   // pool chunk revision it was copied at
+    };
+
+    template<typename C>
+    struct PoolSnapshot {
+        std::vector<std::shared_ptr<const SnapshotChunk<C>>> chunks;
+        std::size_t size{ 0 };
+    };
+
+    template<typename... Cs>
+    struct Snapshot {
+        static_assert(sizeof...(Cs) > 0, "snapshots need a typed reg_ex<Cs...>");
+
+        std::uint64_t                      tick{ 0 };
+        std::shared_ptr<const EntitySlots> slots;
+        std::uint64_t                      slotsVersion{ 0 };
+        std::tuple<PoolSnapshot<Cs>...>    pools;
+
+        [[nodiscard]] bool valid() const noexcept { return slots != nullptr; }
+
+        template<typename C>
+        [[nodiscard]] const PoolSnapshot<C>& pool() const noexcept { return std::get<PoolSnapshot<C>>(pools); }
+
+        // chunks physically copied for this snapshot (the rest are shared)
+        [[nodiscard]] std::size_t fresh_chunks(const Snapshot* previous) const noexcept {
+            std::size_t n = 0;
+            (count_fresh<Cs>(previous, n), ...);
+            return n;
+        }
+
+    private:
+        template<typename C>
+        void count_fresh(const Snapshot* previous, std::size_t& n) const noexcept {
+            const auto& mine = pool<C>().chunks;
+            for (std::size_t c = 0; c < mine.size(); ++c) {
+                const bool shared = previous && c < previous->template pool<C>().chunks.size()
+                    && previous->template pool<C>().chunks[c] == mine[c];
+                n += shared ? 0 : 1;
+            }
+        }
+    };
+
+    namespace _detail {
+        template<typename C>
+        inline void snapshot_pool(const ComponentPool<C>& live, PoolSnapshot<C>& out,
+            const PoolSnapshot<C>* prev)
+        {
+            constexpr std::size_t chunkSize = snapshot_chunk_size<C>;
+            const auto ents = live.entities();
+            const auto data = live.data();
+            const auto revs = live.chunk_revisions();
+
+            out.size = ents.size();
+            out.chunks.clear();
+            out.chunks.reserve(revs.size());
+
+            for (std::size_t c = 0; c < revs.size(); ++c) {
+                // untouched since the previous snapshot copied it: share it
+                if (prev && c < prev->chunks.size() && prev->chunks[c]->revision == revs[c]) {
+                    out.chunks.push_back(prev->chunks[c]);
+                    continue;
+                }
+
+                const std::size_t begin = c * chunkSize;
+                const std::size_t end = std::min(begin + chunkSize, ents.size());
+                auto chunk = std::make_shared<SnapshotChunk<C>>();
+                chunk->entities.assign(ents.begin() + begin, ents.begin() + end);
+                chunk->data.assign(data.begin() + begin, data.begin() + end);
+                chunk->revision = revs[c];
+                out.chunks.push_back(std::move(chunk));
+            }
+        }
+
+        template<typename C>
+        inline void restore_pool(ComponentPool<C>& live, const PoolSnapshot<C>& snap, std::uint64_t tick) {
+            live.clear();
+            live.reserve(snap.size);
+            for (auto& chunk : snap.chunks)
+                for (std::size_t i = 0; i < chunk->entities.size(); ++i)
+                    live.emplace_at(tick, chunk->entities[i], chunk->data[i]);
+        }
+    }
+
+    // capture R, sharing unchanged chunks with `previous`; seals R.tick
+    template<typename... Cs>
+    [[nodiscard]] inline Snapshot<Cs...> take_snapshot(reg_ex<Cs...>& R, const Snapshot<Cs...>* previous = nullptr) {
+        static_assert(reg_ex<Cs...>::typed, "snapshots need a typed reg_ex<Cs...>");
+        if (previous && !previous->valid()) previous = nullptr;
+
+        Snapshot<Cs...> snap;
+        snap.tick = R.tick;
+        snap.slotsVersion = R.slots.version;
+        snap.slots = (previous && previous->slotsVersion == R.slots.version)
+            ? previous->slots
+            : std::make_shared<const EntitySlots>(R.slots);
+
+        (_detail::snapshot_pool<Cs>(std::get<ComponentPool<Cs>>(R.storage),
+            std::get<PoolSnapshot<Cs>>(snap.pools),
+            previous ? &previous->template pool<Cs>() : nullptr), ...);
+
+        advance_tick(R);
+        return snap;
+    }
+
+    // roll R back to `snap`; restored components are stamped as changed now
+    template<typename... Cs>
+    inline void restore_snapshot(reg_ex<Cs...>& R, const Snapshot<Cs...>& snap) {
+        if (!snap.valid()) return;
+        // version only moves forward: caches keyed on it must see the rewind
+        const auto version = std::max(R.slots.version, snap.slots->version) + 1;
+        R.slots = *snap.slots;
+        R.slots.version = version;
+        (_detail::restore_pool<Cs>(std::get<ComponentPool<Cs>>(R.storage),
+            std::get<PoolSnapshot<Cs>>(snap.pools), R.tick), ...);
+    }
+
+    // fn(Entity, const C* before, const C* after) for every C that differs
+    // between two snapshots of the same registry; nullptr = absent on that
+    // side. Only chunks that are not shared are looked at.
+    template<typename C, typename... Cs, typename Fn>
+    inline void diff_snapshots(const Snapshot<Cs...>& a, const Snapshot<Cs...>& b, Fn&& fn) {
+        const auto& pa = a.template pool<C>().chunks;
+        const auto& pb = b.template pool<C>().chunks;
+        const std::size_t n = std::max(pa.size(), pb.size());
+
+        // an entity in a changed chunk of b is either in a changed chunk of a
+        // or new: shared chunks hold the same entities in the same slots
+        std::unordered_map<Entity, const C*> before;
+        for (std::size_t c = 0; c < n; ++c) {
+            if (c < pa.size() && c < pb.size() && pa[c] == pb[c]) continue;
+            if (c < pa.size())
+                for (std::size_t i = 0; i < pa[c]->entities.size(); ++i)
+                    before.emplace(pa[c]->entities[i], &pa[c]->data[i]);
+        }
+
+        for (std::size_t c = 0; c < n; ++c) {
+            if (c < pa.size() && c < pb.size() && pa[c] == pb[c]) continue;
+            if (c >= pb.size()) continue;
+            for (std::size_t i = 0; i < pb[c]->entities.size(); ++i) {
+                const Entity e = pb[c]->entities[i];
+                const C* now = &pb[c]->data[i];
+                const C* was = nullptr;
+                if (auto it = before.find(e); it != before.end()) {
+                    was = it->second;
+                    before.erase(it);
+                }
+                if constexpr (std::equality_comparable<C>) {
+                    if (was && *was == *now) continue;
+                }
+                fn(e, was, now);
+            }
+        }
+        for (auto& [e, was] : before) fn(e, was, static_cast<const C*>(nullptr));
+    }
+
+} // namespace almondnamespace::ecs
@@ -0,0 +1,607 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aecsspatial.hpp
+#pragma once
+
+#include "aplatform.hpp"          // must always come first
+
+#include "aecs.hpp"               // reg_ex, view_changed, find_pool
+#include "aentitycomponents.hpp"  // Position
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace almondnamespace::ecs
+{
+    struct Aabb {
+        float minX{ 0 }, minY{ 0 };
+        float maxX{ 0 }, maxY{ 0 };
+    };
+
+    namespace _detail {
+        struct SpatialRecord {
+            Entity        entity{ null_entity };
+            float         x{ 0 }, y{ 0 };
+            float         radius{ 0 };
+            std::uint64_t bucket{ 0 };   // grid cell key or quadtree node index
+            std::uint32_t slot{ 0 };     // position inside that bucket's list
+        };
+
+        // entity → record slot, keyed by the dense entity index
+        class SpatialSlots {
+        public:
+            static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+            [[nodiscard]] std::uint32_t find(Entity e, const std::vector<SpatialRecord>& recs) const noexcept {
+                const auto s = find_index(e);
+                return (s != npos && recs[s].entity == e) ? s : npos;
+            }
+
+            // slot of whichever generation currently holds e's index
+            [[nodiscard]] std::uint32_t find_index(Entity e) const noexcept {
+                const auto i = entity_index(e);
+                return i < map_.size() ? map_[i] : npos;
+            }
+
+            void set(Entity e, std::uint32_t slot) {
+                const auto i = entity_index(e);
+                if (i >= map_.size()) map_.resize(static_cast<std::size_t>(i) + 1, npos);
+                map_[i] = slot;
+            }
+
+            void reset(Entity e) noexcept {
+                const auto i = entity_index(e);
+                if (i < map_.size()) map_[i] = npos;
+            }
+
+            void clear() noexcept { map_.clear(); }
+
+        private:
+            std::vector<std::uint32_t> map_;
+        };
+
+        // bounded max-heap of (distance², entity) for k-nearest
+        struct NearestHeap {
+            std::size_t k;
+            std::vector<std::pair<float, Entity>> items;
+
+            [[nodiscard]] bool  full() const noexcept { return items.size() >= k; }
+            [[nodiscard]] float worst() const noexcept {
+                return items.empty() ? std::numeric_limits<float>::infinity() : items.front().first;
+            }
+
+            void offer(float d2, Entity e) {
+                if (!full()) {
+                    items.emplace_back(d2, e);
+                    std::push_heap(items.begin(), items.end());
+                }
+                else if (d2 < items.front().first) {
+                    std::pop_heap(items.begin(), items.end());
+                    items.back() = { d2, e };
+                    std::push_heap(items.begin(), items.end());
+                }
+            }
+
+            std::size_t emit(std::vector<Entity>& out) {
+                std::sort_heap(items.begin(), items.end());
+                out.clear();
+                out.reserve(items.size());
+                for (auto& [d, e] : items) out.push_back(e);
+                return out.size();
+            }
+        };
+
+        [[nodiscard]] inline bool overlaps(const SpatialRecord& r, const Aabb& b) noexcept {
+            return r.x + r.radius >= b.minX && r.x - r.radius <= b.maxX
+                && r.y + r.radius >= b.minY && r.y - r.radius <= b.maxY;
+        }
+    }
+
+    // ─── SpatialHashGrid ────────────────────────────────────────────────────
+    // Unbounded uniform grid; only occupied cells exist. A move that stays in
+    // its cell is a store, crossing a cell is two swap‑and‑pops. Queries cost
+    // the cells they touch plus the entities found there.
+    class SpatialHashGrid {
+    public:
+        explicit SpatialHashGrid(float cellSize = 64.0f)
+            : cellSize_(cellSize), invCell_(1.0f / cellSize) {
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return records_.size(); }
+        [[nodiscard]] bool contains(Entity e) const noexcept { return slots_.find(e, records_) != slots_.npos; }
+
+        template<typename Fn>
+        void for_each(Fn&& fn) const {
+            for (auto& r : records_) fn(r.entity);
+        }
+
+        void clear() noexcept {
+            records_.clear();
+            cells_.clear();
+            slots_.clear();
+            maxRadius_ = 0;
+        }
+
+        // insert or move
+        void update(Entity e, float x, float y, float radius = 0.0f) {
+            maxRadius_ = std::max(maxRadius_, radius);
+            const auto [cx, cy] = cell_of(x, y);
+            const auto key = pack(cx, cy);
+
+            if (auto s = slots_.find_index(e); s != slots_.npos) {
+                auto& r = records_[s];
+                if (r.entity == e) {
+                    r.x = x; r.y = y; r.radius = radius;
+                    if (r.bucket != key) {
+                        unlink(s);
+                        link(s, key, cx, cy);
+                    }
+                    return;
+                }
+                erase(r.entity);  // index recycled: the old generation is dead
+            }
+
+            const auto s = static_cast<std::uint32_t>(records_.size());
+            records_.push_back({ e, x, y, radius, key, 0 });
+            slots_.set(e, s);
+            link(s, key, cx, cy);
+        }
+
+        bool erase(Entity e) {
+            const auto s = slots_.find(e, records_);
+            if (s == slots_.npos) return false;
+            unlink(s);
+
+            const auto last = static_cast<std::uint32_t>(records_.size() - 1);
+            if (s != last) {
+                records_[s] = records_[last];
+                slots_.set(records_[s].entity, s);
+                cells_[records_[s].bucket][records_[s].slot] = s;
+            }
+            records_.pop_back();
+            slots_.reset(e);
+            return true;
+        }
+
+        // fn(Entity) for every entity whose extent overlaps `box`
+        template<typename Fn>
+        void query_aabb(const Aabb& box, Fn&& fn) const {
+            const auto [x0, y0] = cell_of(box.minX - maxRadius_, box.minY - maxRadius_);
+            const auto [x1, y1] = cell_of(box.maxX + maxRadius_, box.maxY + maxRadius_);
+
+            auto visit = [&](const std::vector<std::uint32_t>& list) {
+                for (auto s : list)
+                    if (_detail::overlaps(records_[s], box)) fn(records_[s].entity);
+            };
+
+            const auto span = (static_cast<std::uint64_t>(x1 - x0) + 1) * (static_cast<std::uint64_t>(y1 - y0) + 1);
+            if (span > cells_.size()) {
+                // query wider than the populated world: walk occupied cells instead
+                for (auto& [key, list] : cells_) {
+                    const auto [cx, cy] = unpack(key);
+                    if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1) visit(list);
+                }
+                return;
+            }
+            for (auto cy = y0; cy <= y1; ++cy)
+                for (auto cx = x0; cx <= x1; ++cx)
+                    if (auto it = cells_.find(pack(cx, cy)); it != cells_.end()) visit(it->second);
+        }
+
+        // fn(Entity, float distanceSquared) for every entity within `radius`
+        template<typename Fn>
+        void query_radius(float x, float y, float radius, Fn&& fn) const {
+            query_aabb({ x - radius, y - radius, x + radius, y + radius }, [&](Entity e) {
+                const auto& r = records_[slots_.find(e, records_)];
+                const float dx = r.x - x, dy = r.y - y;
+                const float d2 = dx * dx + dy * dy;
+                const float reach = radius + r.radius;
+                if (d2 <= reach * reach) fn(e, d2);
+            });
+        }
+
+        // up to k entities nearest to (x, y), closest first; rings of cells
+        // are searched outward until no unvisited cell can beat the k‑th hit
+        std::size_t k_nearest(float x, float y, std::size_t k, std::vector<Entity>& out,
+            float maxDistance = std::numeric_limits<float>::infinity()) const
+        {
+            _detail::NearestHeap heap{ k, {} };
+            out.clear();
+            if (k == 0 || records_.empty()) return 0;
+
+            const auto [ccx, ccy] = cell_of(x, y);
+            std::int64_t maxRing = std::max({ std::abs(std::int64_t(ccx) - minCx_), std::abs(std::int64_t(ccx) - maxCx_),
+                                              std::abs(std::int64_t(ccy) - minCy_), std::abs(std::int64_t(ccy) - maxCy_) });
+            if (std::isfinite(maxDistance))
+                maxRing = std::min<std::int64_t>(maxRing, static_cast<std::int64_t>(std::ceil(maxDistance * invCell_)) + 1);
+            const float maxD2 = maxDistance * maxDistance;
+
+            auto visit = [&](std::int64_t cx, std::int64_t cy) {
+                auto it = cells_.find(pack(static_cast<std::int32_t>(cx), static_cast<std::int32_t>(cy)));
+                if (it == cells_.end()) return;
+                for (auto s : it->second) {
+                    const auto& r = records_[s];
+                    const float dx = r.x - x, dy = r.y - y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (d2 <= maxD2) heap.offer(d2, r.entity);
+                }
+            };
+
+            for (std::int64_t ring = 0; ring <= maxRing; ++ring) {
+                if (ring == 0) {
+                    visit(ccx, ccy);
+                }
+                else {
+                    for (std::int64_t d = -ring; d <= ring; ++d) {
+                        visit(ccx + d, ccy - ring);
+                        visit(ccx + d, ccy + ring);
+                    }
+                    for (std::int64_t d = -ring + 1; d <= ring - 1; ++d) {
+                        visit(ccx - ring, ccy + d);
+                        visit(ccx + ring, ccy + d);
+                    }
+                }
+                const float reach = static_cast<float>(ring) * cellSize_;
+                if (heap.full() && heap.worst() <= reach * reach) break;
+            }
+            return heap.emit(out);
+        }
+
+    private:
+        struct CellHash {
+            std::size_t operator()(std::uint64_t k) const noexcept {
+                k ^= k >> 33; k *= 0xff51afd7ed558ccdULL; k ^= k >> 33;
+                return static_cast<std::size_t>(k);
+            }
+        };
+
+        [[nodiscard]] std::pair<std::int32_t, std::int32_t> cell_of(float x, float y) const noexcept {
+            return { static_cast<std::int32_t>(std::floor(x * invCell_)),
+                     static_cast<std::int32_t>(std::floor(y * invCell_)) };
+        }
+
+        static std::uint64_t pack(std::int32_t cx, std::int32_t cy) noexcept {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+        }
+
+        static std::pair<std::int32_t, std::int32_t> unpack(std::uint64_t key) noexcept {
+            return { static_cast<std::int32_t>(key >> 32), static_cast<std::int32_t>(key & 0xFFFF'FFFFu) };
+        }
+
+        void link(std::uint32_t s, std::uint64_t key, std::int32_t cx, std::int32_t cy) {
+            auto& list = cells_[key];
+            records_[s].bucket = key;
+            records_[s].slot = static_cast<std::uint32_t>(list.size());
+            list.push_back(s);
+            // conservative populated extent, only ever grows (bounds k‑nearest rings)
+            minCx_ = std::min(minCx_, cx); maxCx_ = std::max(maxCx_, cx);
+            minCy_ = std::min(minCy_, cy); maxCy_ = std::max(maxCy_, cy);
+        }
+
+        void unlink(std::uint32_t s) {
+            auto it = cells_.find(records_[s].bucket);
+            auto& list = it->second;
+            const auto pos = records_[s].slot;
+            list[pos] = list.back();
+            records_[list[pos]].slot = pos;
+            list.pop_back();
+            if (list.empty()) cells_.erase(it);
+        }
+
+        float cellSize_;
+        float invCell_;
+        float maxRadius_{ 0 };
+        std::int32_t minCx_{ std::numeric_limits<std::int32_t>::max() }, maxCx_{ std::numeric_limits<std::int32_t>::min() };
+        std::int32_t minCy_{ std::numeric_limits<std::int32_t>::max() }, maxCy_{ std::numeric_limits<std::int32_t>::min() };
+        std::vector<_detail::SpatialRecord> records_;
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>, CellHash> cells_;
+        _detail::SpatialSlots slots_;
+    };
+
+    // ─── LooseQuadtree ──────────────────────────────────────────────────────
+    // Bounded world, nodes created on demand. Each node's loose bounds are
+    // twice its cell, so an entity lives in the deepest node whose cell holds
+    // its centre and whose half‑size is ≥ its radius: no straddling, no
+    // re‑insert on small moves. Better than the grid for mixed entity sizes
+    // and strongly clustered worlds.
+    class LooseQuadtree {
+    public:
+        explicit LooseQuadtree(const Aabb& world = { -4096, -4096, 4096, 4096 }, std::uint32_t maxDepth = 8)
+            : maxDepth_(maxDepth)
+        {
+            const float half = std::max(world.maxX - world.minX, world.maxY - world.minY) * 0.5f;
+            nodes_.push_back({ (world.minX + world.maxX) * 0.5f, (world.minY + world.maxY) * 0.5f, half, -1, 0, {} });
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return records_.size(); }
+        [[nodiscard]] bool contains(Entity e) const noexcept { return slots_.find(e, records_) != slots_.npos; }
+
+        template<typename Fn>
+        void for_each(Fn&& fn) const {
+            for (auto& r : records_) fn(r.entity);
+        }
+
+        void clear() noexcept {
+            records_.clear();
+            slots_.clear();
+            nodes_.resize(1);
+            nodes_[0].firstChild = -1;
+            nodes_[0].items.clear();
+        }
+
+        void update(Entity e, float x, float y, float radius = 0.0f) {
+            const auto node = target_node(x, y, radius);
+
+            if (auto s = slots_.find_index(e); s != slots_.npos) {
+                auto& r = records_[s];
+                if (r.entity == e) {
+                    r.x = x; r.y = y; r.radius = radius;
+                    if (r.bucket != node) {
+                        unlink(s);
+                        link(s, node);
+                    }
+                    return;
+                }
+                erase(r.entity);  // index recycled: the old generation is dead
+            }
+
+            const auto s = static_cast<std::uint32_t>(records_.size());
+            records_.push_back({ e, x, y, radius, node, 0 });
+            slots_.set(e, s);
+            link(s, node);
+        }
+
+        bool erase(Entity e) {
+            const auto s = slots_.find(e, records_);
+            if (s == slots_.npos) return false;
+            unlink(s);
+
+            const auto last = static_cast<std::uint32_t>(records_.size() - 1);
+            if (s != last) {
+                records_[s] = records_[last];
+                slots_.set(records_[s].entity, s);
+                nodes_[records_[s].bucket].items[records_[s].slot] = s;
+            }
+            records_.pop_back();
+            slots_.reset(e);
+            return true;
+        }
+
+        template<typename Fn>
+        void query_aabb(const Aabb& box, Fn&& fn) const {
+            std::vector<std::uint32_t> stack{ 0 };
+            while (!stack.empty()) {
+                const auto n = stack.back();
+                stack.pop_back();
+                const auto& node = nodes_[n];
+                // the root also holds anything outside the world, never prune it
+                if (n != 0 && !loose_overlaps(node, box)) continue;
+                for (auto s : node.items)
+                    if (_detail::overlaps(records_[s], box)) fn(records_[s].entity);
+                if (node.firstChild >= 0)
+                    for (std::uint32_t c = 0; c < 4; ++c) stack.push_back(static_cast<std::uint32_t>(node.firstChild) + c);
+            }
+        }
+
+        template<typename Fn>
+        void query_radius(float x, float y, float radius, Fn&& fn) const {
+            query_aabb({ x - radius, y - radius, x + radius, y + radius }, [&](Entity e) {
+                const auto& r = records_[slots_.find(e, records_)];
+                const float dx = r.x - x, dy = r.y - y;
+                const float d2 = dx * dx + dy * dy;
+                const float reach = radius + r.radius;
+                if (d2 <= reach * reach) fn(e, d2);
+            });
+        }
+
+        // best‑first over nodes ordered by distance to their loose bounds
+        std::size_t k_nearest(float x, float y, std::size_t k, std::vector<Entity>& out,
+            float maxDistance = std::numeric_limits<float>::infinity()) const
+        {
+            _detail::NearestHeap heap{ k, {} };
+            out.clear();
+            if (k == 0 || records_.empty()) return 0;
+            const float maxD2 = maxDistance * maxDistance;
+
+            using Item = std::pair<float, std::uint32_t>;
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+            open.push({ 0.0f, 0 });
+
+            while (!open.empty()) {
+                const auto [nd2, n] = open.top();
+                open.pop();
+                if (nd2 > maxD2 || (heap.full() && nd2 > heap.worst())) break;
+
+                const auto& node = nodes_[n];
+                for (auto s : node.items) {
+                    const auto& r = records_[s];
+                    const float dx = r.x - x, dy = r.y - y;
+                    const float d2 = dx * dx + dy * dy;
+                    if (d2 <= maxD2) heap.offer(d2, r.entity);
+                }
+                if (node.firstChild >= 0) {
+                    for (std::uint32_t c = 0; c < 4; ++c) {
+                        const auto ci = static_cast<std::uint32_t>(node.firstChild) + c;
+                        open.push({ loose_distance_sq(nodes_[ci], x, y), ci });
+                    }
+                }
+            }
+            return heap.emit(out);
+        }
+
+    private:
+        struct Node {
+            float cx, cy, half;               // tight cell; loose bounds are ±2·half
+            std::int32_t firstChild;          // four consecutive children, or -1
+            std::uint32_t depth;
+            std::vector<std::uint32_t> items;
+        };
+
+        static bool loose_overlaps(const Node& n, const Aabb& b) noexcept {
+            const float h = n.half * 2.0f;
+            return b.maxX >= n.cx - h && b.minX <= n.cx + h
+                && b.maxY >= n.cy - h && b.minY <= n.cy + h;
+        }
+
+        static float loose_distance_sq(const Node& n, float x, float y) noexcept {
+            const float h = n.half * 2.0f;
+            const float dx = std::max({ n.cx - h - x, 0.0f, x - (n.cx + h) });
+            const float dy = std::max({ n.cy - h - y, 0.0f, y - (n.cy + h) });
+            return dx * dx + dy * dy;
+        }
+
+        std::uint32_t target_node(float x, float y, float radius) {
+            std::uint32_t n = 0;
+            const auto& root = nodes_[0];
+            if (std::abs(x - root.cx) > root.half || std::abs(y - root.cy) > root.half) return 0;
+
+            while (nodes_[n].depth < maxDepth_ && radius <= nodes_[n].half * 0.5f) {
+                if (nodes_[n].firstChild < 0) split(n);
+                const auto& node = nodes_[n];
+                const std::uint32_t q = (x >= node.cx ? 1u : 0u) | (y >= node.cy ? 2u : 0u);
+                n = static_cast<std::uint32_t>(node.firstChild) + q;
+            }
+            return n;
+        }
+
+        void split(std::uint32_t n) {
+            const auto first = static_cast<std::int32_t>(nodes_.size());
+            const Node parent = { nodes_[n].cx, nodes_[n].cy, nodes_[n].half, -1, nodes_[n].depth, {} };
+            const float h = parent.half * 0.5f;
+            for (std::uint32_t q = 0; q < 4; ++q) {
+                nodes_.push_back({ parent.cx + ((q & 1u) ? h : -h), parent.cy + ((q & 2u) ? h : -h),
+                                   h, -1, parent.depth + 1, {} });
+            }
+            nodes_[n].firstChild = first;
+        }
+
+        void link(std::uint32_t s, std::uint64_t node) {
+            auto& items = nodes_[node].items;
+            records_[s].bucket = node;
+            records_[s].slot = static_cast<std::uint32_t>(items.size());
+            items.push_back(s);
+        }
+
+        void unlink(std::uint32_t s) {
+            auto& items = nodes_[records_[s].bucket].items;
+            const auto pos = records_[s].slot;
+            items[pos] = items.back();
+            records_[items[pos]].slot = pos;
+            items.pop_back();
+        }
+
+        std::uint32_t maxDepth_;
+        std::vector<Node> nodes_;
+        std::vector<_detail::SpatialRecord> records_;
+        _detail::SpatialSlots slots_;
+    };
+
+    // ─── SpatialIndex : the one systems hold ────────────────────────────────
+    enum class SpatialIndexKind : std::uint8_t { HashGrid, LooseQuadtree };
+
+    struct SpatialIndexConfig {
+        SpatialIndexKind kind = SpatialIndexKind::HashGrid;
+        float            cellSize = 64.0f;                       // HashGrid
+        Aabb             world{ -4096, -4096, 4096, 4096 };      // LooseQuadtree
+        std::uint32_t    maxDepth = 8;                           // LooseQuadtree
+    };
+
+    class SpatialIndex {
+    public:
+        explicit SpatialIndex(const SpatialIndexConfig& config = {}) {
+            if (config.kind == SpatialIndexKind::LooseQuadtree)
+                impl_.emplace<LooseQuadtree>(config.world, config.maxDepth);
+            else
+                impl_.emplace<SpatialHashGrid>(config.cellSize);
+        }
+
+        std::uint64_t synced_tick{ 0 };   // last tick sync_spatial_index consumed
+
+        [[nodiscard]] std::size_t size() const noexcept { return std::visit([](auto& i) { return i.size(); }, impl_); }
+        [[nodiscard]] bool contains(Entity e) const noexcept { return std::visit([&](auto& i) { return i.contains(e); }, impl_); }
+
+        void update(Entity e, float x, float y, float radius = 0.0f) {
+            std::visit([&](auto& i) { i.update(e, x, y, radius); }, impl_);
+        }
+        bool erase(Entity e) { return std::visit([&](auto& i) { return i.erase(e); }, impl_); }
+        void clear() noexcept {
+            std::visit([](auto& i) { i.clear(); }, impl_);
+            synced_tick = 0;
+        }
+
+        template<typename Fn> void for_each(Fn&& fn) const {
+            std::visit([&](auto& i) { i.for_each(fn); }, impl_);
+        }
+        template<typename Fn> void query_aabb(const Aabb& box, Fn&& fn) const {
+            std::visit([&](auto& i) { i.query_aabb(box, fn); }, impl_);
+        }
+        template<typename Fn> void query_radius(float x, float y, float radius, Fn&& fn) const {
+            std::visit([&](auto& i) { i.query_radius(x, y, radius, fn); }, impl_);
+        }
+        std::size_t k_nearest(float x, float y, std::size_t k, std::vector<Entity>& out,
+            float maxDistance = std::numeric_limits<float>::infinity()) const {
+            return std::visit([&](auto& i) { return i.k_nearest(x, y, k, out, maxDistance); }, impl_);
+        }
+
+        [[nodiscard]] SpatialIndexKind kind() const noexcept {
+            return std::holds_alternative<LooseQuadtree>(impl_) ? SpatialIndexKind::LooseQuadtree : SpatialIndexKind::HashGrid;
+        }
+
+    private:
+        std::variant<SpatialHashGrid, LooseQuadtree> impl_;
+    };
+
+    // ─── sync with the registry ─────────────────────────────────────────────
+    // Pulls only the P components added/written since the last sync (see
+    // view_changed). Removed components are swept only when the index holds
+    // more entries than the pool — after the upserts the index is a superset,
+    // so equal sizes mean nothing was dropped. Call once per tick before the
+    // systems that query.
+    template<typename P = Position, typename... Cs>
+    inline void sync_spatial_index(reg_ex<Cs...>& R, SpatialIndex& index) {
+        const auto* p = find_pool<P>(std::as_const(R));
+        if (!p) {
+            index.clear();
+            return;
+        }
+
+        view_changed<P>(R, index.synced_tick, [&](Entity e, const P& pos) {
+            index.update(e, static_cast<float>(pos.x), static_cast<float>(pos.y));
+        });
+        // writes later in this same tick carry this stamp too: re‑check them next time
+        index.synced_tick = R.tick ? R.tick - 1 : 0;
+
+        if (index.size() > p->size()) {
+            std::vector<Entity> stale;
+            index.for_each([&](Entity e) { if (!p->contains(e)) stale.push_back(e); });
+            for (auto e : stale) index.erase(e);
+        }
+    }
+
+} // namespace almondnamespace::ecs
@@ -46,15 +46,13 @@ namespace almondnamespace::app
     {
         int mx = 0, my = 0;
         ctx.get_mouse_position(mx, my);
-        events::push_event({ events::EventType::MouseMove, {}, float(mx), float(my) });
+        events::post(events::MouseMoveEvent{ float(mx), float(my) });
 
         if (ctx.is_mouse_button_down(input::MouseButton::MouseLeft))
-            events::push_event({ events::EventType::MouseButtonClick,
-                                 {{"button","left"}}, float(mx), float(my) });
+            events::post(events::MouseButtonEvent{ input::MouseButton::MouseLeft, true, float(mx), float(my) });
 
         if (ctx.is_key_down(input::Key::Escape))
-            events::push_event({ events::EventType::KeyPress,
-                                 {{"key","escape"}} });
+            events::post(events::KeyEvent{ input::Key::Escape, true });
     }
 
     // ─── Main loop (ECS-free stub – slots neatly into your engine) ─────
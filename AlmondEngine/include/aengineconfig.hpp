@@ -41,6 +41,7 @@
 //#define DEBUG_TEXTURE_RENDERING_VERBOSE
 //#define DEBUG_TEXTURE_RENDERING_VERY_VERBOSE
 //#define DEBUG_WINDOW_VERBOSE
+//#define ALMOND_TRACK_ALLOCATIONS // global operator new hook, per-subsystem counters (amemorytracker.hpp); define project-wide
 // 
 // 
 // --------------------
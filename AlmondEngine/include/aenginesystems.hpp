@@ -22,10 +22,11 @@
 #pragma once
 
 #include "aplatform.hpp"
-#include "ampmcboundedqueue.hpp"   // Lock‑free MPMCQueue<T>
+#include "aworkstealingscheduler.hpp" // jobs::scheduler()
 #include "anet.hpp"                // for poll()
 
 #include <span>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <fstream>
@@ -40,14 +41,28 @@ namespace almondnamespace
 {
     // —————————————————————————————————————————————————————————————————
     // Coroutine Task (public coroutine handle type)
+    // One-shot handle the task graph resumes; no result, no continuation.
+    // For awaitable work with results use coro::Task<T> (acoroutine.hpp).
     // —————————————————————————————————————————————————————————————————
     struct Task {
         struct promise_type {
             Task get_return_object() {
                 return Task{ std::coroutine_handle<promise_type>::from_promise(*this) };
             }
+            // set once the body has run to its end; the frame is never
+            // touched again by the resuming thread after this store
+            struct final_awaiter {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+                    h.promise().finished.store(true, std::memory_order_release);
+                }
+                void await_resume() const noexcept {}
+            };
+
+            std::atomic<bool> finished{ false };
+
             std::suspend_always initial_suspend() noexcept { return {}; }
-            std::suspend_always final_suspend() noexcept { return {}; }
+            final_awaiter final_suspend() noexcept { return {}; }
             void return_void() noexcept {}
             void unhandled_exception() { std::terminate(); }
         };
@@ -58,50 +73,32 @@ namespace almondnamespace
         explicit Task(handle_t h_) noexcept : h(h_) {}
         Task(Task&& o) noexcept : h(o.h) { o.h = nullptr; }
         ~Task() { if (h) h.destroy(); }
+
+        // safe to call while another thread resumes the coroutine, unlike h.done()
+        [[nodiscard]] bool finished() const noexcept {
+            return h && h.promise().finished.load(std::memory_order_acquire);
+        }
         Task(const Task&) = delete;
         Task& operator=(const Task&) = delete;
     };
 
     // —————————————————————————————————————————————————————————————————
-    // Internal job queue + worker pool
+    // Worker pool — thin wrappers over the work‑stealing scheduler
+    // (per‑worker deques, global injection queue, idle workers park)
     // —————————————————————————————————————————————————————————————————
-    static MPMCQueue<std::function<void()>> g_jobQueue{ 1024 };
-    static std::vector<std::thread>         g_workers;
-    static std::atomic<bool>                g_running{ false };
-
-    inline void scheduler_start(int threadCount) {
-        g_running = true;
-        for (int i = 0; i < threadCount; ++i) {
-            g_workers.emplace_back([] {
-                std::function<void()> job;
-                while (g_running) {
-                    if (g_jobQueue.dequeue(job)) {
-                        job();
-                    }
-                    else {
-                        std::this_thread::yield();
-                    }
-                }
-                // Drain remaining jobs
-                while (g_jobQueue.dequeue(job)) {
-                    job();
-                }
-                });
-        }
+    inline void scheduler_start(int threadCount, bool pinThreads = false) {
+        jobs::SchedulerConfig cfg;
+        cfg.workers = static_cast<unsigned>(std::max(threadCount, 1));
+        cfg.pinThreads = pinThreads;
+        jobs::scheduler().start(cfg);
     }
 
     inline void scheduler_stop() {
-        g_running = false;
-        for (auto& t : g_workers) {
-            if (t.joinable()) t.join();
-        }
-        g_workers.clear();
+        jobs::scheduler().stop();
     }
 
     inline void scheduler_enqueue(std::function<void()> job) {
-        while (!g_jobQueue.enqueue(std::move(job))) {
-            std::this_thread::yield();
-        }
+        jobs::scheduler().submit(std::move(job));
     }
 
     // —————————————————————————————————————————————————————————————————
@@ -109,27 +106,28 @@ namespace almondnamespace
     // —————————————————————————————————————————————————————————————————
 
     // LoadAssetAwaitable — runs blocking disk I/O on a worker
+    // (resumes on that worker; coro::read_file is the Task-based equivalent)
     struct LoadAssetAwaitable {
         std::string path;
+        std::vector<std::byte> bytes{}; // filled on the worker, lives in the awaiting frame
 
         bool await_ready() const noexcept { return false; }
 
-        void await_suspend(std::coroutine_handle<> h) const noexcept {
-            scheduler_enqueue([h, path = path]() {
+        void await_suspend(std::coroutine_handle<> h) noexcept {
+            scheduler_enqueue([h, this]() {
                 std::ifstream in(path, std::ios::binary);
-                std::vector<std::byte> buf;
                 if (in) {
                     in.seekg(0, std::ios::end);
-                    buf.resize(static_cast<size_t>(in.tellg()));
+                    bytes.resize(static_cast<size_t>(in.tellg()));
                     in.seekg(0);
-                    in.read(reinterpret_cast<char*>(buf.data()), buf.size());
+                    in.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
                 }
                 h.resume(); // fire coroutine again
                 });
         }
 
-        std::vector<std::byte> await_resume() const noexcept {
-            return {}; // optionally store/retrieve result externally
+        std::vector<std::byte> await_resume() noexcept {
+            return std::move(bytes);
         }
     };
 
@@ -26,32 +26,41 @@
 
  // High‑level entity helpers (header‑only, functional)
 #include "aecs.hpp"                 // reg_ex<…>
-#include "aentitycomponents.hpp"    // Position, History, LoggerComponent
-#include "aeventsystem.hpp"         // push_event
-#include "alogger.hpp"
+#include "aentitycomponents.hpp"    // Position, LoggerComponent
+#include "aentityhistory.hpp"       // History
+#include "alogger.hpp"              // LogLevel
 #include "arobusttime.hpp"
 
+#include <string>
 #include <string_view>
-#include <format>
 
 namespace almondnamespace::ecs
 {
+    // Logging and eventing for these helpers goes through R.journal; call
+    // flush_journal(R) once per frame instead of paying for it per call;
+    // it writes to the registry's Logger (make_registry(&log, &clock)).
+
     // ─── spawn_entity ──────────────────────────────────────────────────
     template<typename... Cs>
-    inline Entity spawn_entity(reg_ex<Cs...>& R, std::string_view logfile, almondnamespace::LogLevel lvl, time::Timer& clock)
+    inline Entity spawn_entity(reg_ex<Cs...>& R)
     {
         Entity e = create_entity(R);
 
         add_component<Position>(R, e, {});
-        add_component<History >(R, e, { {{0.f,0.f}} });
-        add_component<LoggerComponent>(R, e, { std::string(logfile),lvl,&clock });
-
-        // logging
-        if (R.log && R.clk) R.log->log(std::format("[ECS] Entity {} spawned at {}", e, time::getCurrentTimeString()));
+        add_component<History >(R, e, History{});
+        return e;
+    }
 
-        events::push_event({ events::EventType::Custom,
-                             {{"action","spawn"},
-                              {"entity",std::to_string(e)}} });
+    // old signature: the LoggerComponent is still attached (and journaled
+    // like any other add) when the registry can hold one, so code that
+    // reads it keeps working until it moves to flush_journal(R)
+    template<typename... Cs>
+    [[deprecated("use spawn_entity(R) and make_registry(&log, &clock); logging goes through flush_journal(R)")]]
+    inline Entity spawn_entity(reg_ex<Cs...>& R, std::string_view logfile, almondnamespace::LogLevel lvl, time::Timer& clock)
+    {
+        Entity e = spawn_entity(R);
+        if constexpr (!reg_ex<Cs...>::typed || contains_component_v<LoggerComponent, Cs...>)
+            add_component<LoggerComponent>(R, e, { std::string(logfile), lvl, &clock });
         return e;
     }
 
@@ -61,47 +70,27 @@ namespace almondnamespace::ecs
     {
         auto& pos = get_component<Position>(R, e);
         auto& hist = get_component<History >(R, e);
-        hist.states.emplace_back(pos.x, pos.y);        // snapshot
+        save_state(hist, pos.x, pos.y);                // snapshot, bounded ring
 
         pos.x += dx;
         pos.y += dy;
 
-        auto& lc = get_component<LoggerComponent>(R, e);
-        Logger logger{ lc.file, *lc.clock, lc.level };
-        std::string ts = lc.clock->getCurrentTimeString();
-        logger.log(std::format("[ECS] Entity {} moved to ({:.2f},{:.2f}) at {}", e, pos.x, pos.y, ts));
-
-        events::push_event({ events::EventType::Custom,
-                             {{"action","move"},
-                              {"entity",std::to_string(e)},
-                              {"x",std::to_string(pos.x)},
-                              {"y",std::to_string(pos.y)},
-                              {"time",ts}}, pos.x,pos.y });
+        _detail::notify(R, JournalOp::ModifyComponent, e, component_id<Position>());
     }
 
     // ─── rewind_entity ────────────────────────────────────────────────
+    // undo the last `steps` moves (O(1), limited to History::capacity())
     template<typename... Cs>
-    inline bool rewind_entity(reg_ex<Cs...>& R, Entity e)
+    inline bool rewind_entity(reg_ex<Cs...>& R, Entity e, std::size_t steps = 1)
     {
         auto& hist = get_component<History>(R, e);
-        if (hist.states.size() <= 1) return false;
+        float px, py;
+        if (!rewind_state(hist, px, py, steps)) return false;
 
-        hist.states.pop_back();
-        auto [px, py] = hist.states.back();
         auto& pos = get_component<Position>(R, e);
         pos.x = px; pos.y = py;
 
-        auto& lc = get_component<LoggerComponent>(R, e);
-        Logger logger{ lc.file, *lc.clock, lc.level };
-        std::string ts = lc.clock->getCurrentTimeString();
-        logger.log(std::format("[ECS] Entity {} rewound to ({:.2f},{:.2f}) at {}", e, pos.x, pos.y, ts));
-
-        events::push_event({ events::EventType::Custom,
-                             {{"action","rewind"},
-                              {"entity",std::to_string(e)},
-                              {"x",std::to_string(pos.x)},
-                              {"y",std::to_string(pos.y)},
-                              {"time",ts}}, pos.x,pos.y });
+        _detail::notify(R, JournalOp::ModifyComponent, e, component_id<Position>());
         return true;
     }
 } // namespace almondnamespace::ecs
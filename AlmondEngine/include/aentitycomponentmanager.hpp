@@ -24,35 +24,317 @@
 
 #include "aplatform.hpp"   // must always come first
 
+#include <algorithm>
 #include <unordered_map>
 #include <typeindex>
 #include <memory>
+#include <vector>
+#include <span>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <typeinfo>
+#include <utility>
+#include <cstdint>
 #include <cassert>
+#include <stdexcept>
 
 namespace almondnamespace::ecs
 {
-    /// The basic ID type
-    using EntityID = std::size_t;
+    /// The basic ID type: [generation:32][index:32]. The index is dense and
+    /// recycled by reg_ex; the generation tells a slot's owners apart.
+    using EntityID = std::uint64_t;
+    using EntityIndex = std::uint32_t;
+    using EntityGeneration = std::uint32_t;
+
+    /// Never handed out (live generations start at 1)
+    inline constexpr EntityID null_entity = 0;
+
+    [[nodiscard]] constexpr EntityID make_entity(EntityIndex index, EntityGeneration generation) noexcept {
+        return (static_cast<EntityID>(generation) << 32) | index;
+    }
+
+    [[nodiscard]] constexpr EntityIndex entity_index(EntityID entity) noexcept {
+        return static_cast<EntityIndex>(entity & 0xFFFF'FFFFu);
+    }
+
+    [[nodiscard]] constexpr EntityGeneration entity_generation(EntityID entity) noexcept {
+        return static_cast<EntityGeneration>(entity >> 32);
+    }
+
+    /// Small dense id per component type, assigned on first use
+    using ComponentTypeID = std::uint32_t;
+    inline constexpr ComponentTypeID no_component = std::numeric_limits<ComponentTypeID>::max();
+
+    namespace _detail {
+        inline std::atomic<ComponentTypeID>& component_id_counter() noexcept {
+            static std::atomic<ComponentTypeID> next{ 0 };
+            return next;
+        }
+
+        inline std::mutex& component_names_mutex() {
+            static std::mutex m;
+            return m;
+        }
+
+        inline std::vector<const char*>& component_names() {
+            static std::vector<const char*> names;
+            return names;
+        }
+
+        inline ComponentTypeID register_component(const char* name) {
+            std::lock_guard lock(component_names_mutex());
+            auto id = component_id_counter().fetch_add(1, std::memory_order_relaxed);
+            auto& names = component_names();
+            if (names.size() <= id) names.resize(id + 1, "");
+            names[id] = name;
+            return id;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] inline ComponentTypeID component_id() {
+        static const ComponentTypeID id = _detail::register_component(typeid(T).name());
+        return id;
+    }
+
+    /// Readable name for a component id (cold path: logging, debug dumps)
+    [[nodiscard]] inline const char* component_name(ComponentTypeID id) {
+        std::lock_guard lock(_detail::component_names_mutex());
+        auto& names = _detail::component_names();
+        return id < names.size() ? names[id] : "";
+    }
+
+    // ─── IComponentPool ──────────────────────────────────────────────────
+    // Type‑erased face of a pool so storage can drop an entity from every
+    // pool without knowing the component types.
+    struct IComponentPool {
+        virtual ~IComponentPool() = default;
+
+        virtual bool        contains(EntityID entity) const noexcept = 0;
+        virtual void        remove(EntityID entity) = 0;
+        virtual std::size_t size() const noexcept = 0;
+        virtual std::span<const EntityID> entities() const noexcept = 0;
+    };
+
+    // ─── ComponentPool<T> : sparse set ───────────────────────────────────
+    //   sparse : paged entity index → dense slot (pages allocated on demand)
+    //   dense  : packed EntityIDs + packed T, same order, no holes
+    // A lookup only hits when the stored handle matches exactly, so a stale
+    // handle to a recycled index never sees the new owner's component.
+    // Each dense slot also carries the tick it was added and last written,
+    // which the registry's view_added / view_changed filter on, and every
+    // chunk_size run of dense slots carries a revision that any add, write
+    // (touch) or removal in it bumps, so snapshots can skip clean chunks
+    // without looking at their slots.
+    // Removal swaps the last element into the hole, so iteration over
+    // data()/entities() is always a linear walk over contiguous memory.
+    template<typename T>
+    class ComponentPool final : public IComponentPool {
+    public:
+        using value_type = T;
+
+        static constexpr std::size_t page_size = 4096;
+        static constexpr std::size_t chunk_size = 512;   // dense slots per revision
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        [[nodiscard]] bool contains(EntityID entity) const noexcept override {
+            return slot(entity) != npos;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept override { return dense_.size(); }
+        [[nodiscard]] bool        empty() const noexcept { return dense_.empty(); }
+
+        [[nodiscard]] std::span<const EntityID> entities() const noexcept override { return dense_; }
+        [[nodiscard]] std::span<T>              data() noexcept { return data_; }
+        [[nodiscard]] std::span<const T>        data() const noexcept { return data_; }
+
+        /// dense slot of `entity`, or npos
+        [[nodiscard]] std::uint32_t index_of(EntityID entity) const noexcept { return slot(entity); }
+
+        /// emplace stamped with `tick`: a new slot is added+changed at tick,
+        /// replacing an existing component only counts as a change.
+        /// The index must not be held by another generation of the entity
+        /// (callers check liveness first); that is a logic error, never an overwrite.
+        template<typename... Args>
+        T& emplace_at(std::uint64_t tick, EntityID entity, Args&&... args) {
+            if (auto i = slot(entity); i != npos) {
+                data_[i] = T(std::forward<Args>(args)...);
+                changed_[i] = tick;
+                mark(i);
+                return data_[i];
+            }
+            const auto index = entity_index(entity);
+            auto& sparse = assure_page(index)[index % page_size];
+            if (sparse != npos) {
+                assert(false && "ComponentPool: index owned by another generation");
+                throw std::logic_error("ComponentPool::emplace_at: stale entity handle");
+            }
+            sparse = static_cast<std::uint32_t>(dense_.size());
+            dense_.push_back(entity);
+            data_.emplace_back(std::forward<Args>(args)...);
+            added_.push_back(tick);
+            changed_.push_back(tick);
+            if (chunkRev_.size() * chunk_size < dense_.size()) chunkRev_.push_back(0);
+            mark(dense_.size() - 1);
+            return data_.back();
+        }
+
+        /// stamp an existing component as written at `tick`
+        void touch(EntityID entity, std::uint64_t tick) noexcept {
+            if (auto i = slot(entity); i != npos) touch_slot(i, tick);
+        }
+
+        void touch_slot(std::uint32_t i, std::uint64_t tick) noexcept {
+            changed_[i] = tick;
+            mark(i);
+        }
+
+        /// revision per chunk_size dense slots; equal revisions mean the
+        /// chunk's occupants and values are unchanged (given writes touch)
+        [[nodiscard]] std::span<const std::uint64_t> chunk_revisions() const noexcept { return chunkRev_; }
+
+        [[nodiscard]] std::span<const std::uint64_t> added_ticks() const noexcept { return added_; }
+        [[nodiscard]] std::span<const std::uint64_t> changed_ticks() const noexcept { return changed_; }
+
+        [[nodiscard]] T& get(EntityID entity) noexcept {
+            assert(contains(entity) && "Component not found!");
+            return data_[slot(entity)];
+        }
+
+        [[nodiscard]] const T& get(EntityID entity) const noexcept {
+            assert(contains(entity) && "Component not found!");
+            return data_[slot(entity)];
+        }
+
+        [[nodiscard]] T* try_get(EntityID entity) noexcept {
+            auto i = slot(entity);
+            return i != npos ? &data_[i] : nullptr;
+        }
+
+        void remove(EntityID entity) override {
+            const auto i = slot(entity);
+            if (i == npos) return;
+
+            const auto last = static_cast<std::uint32_t>(dense_.size() - 1);
+            if (i != last) {
+                const EntityID moved = dense_[last];
+                dense_[i] = moved;
+                data_[i] = std::move(data_[last]);
+                added_[i] = added_[last];
+                changed_[i] = changed_[last];
+                const auto movedIndex = entity_index(moved);
+                sparse_[movedIndex / page_size][movedIndex % page_size] = i;
+                mark(i);
+            }
+            mark(last);
+            const auto index = entity_index(entity);
+            sparse_[index / page_size][index % page_size] = npos;
+            dense_.pop_back();
+            data_.pop_back();
+            added_.pop_back();
+            changed_.pop_back();
+            if ((chunkRev_.size() - 1) * chunk_size >= dense_.size()) chunkRev_.pop_back();
+        }
+
+        // revisions keep counting, so nothing captured before compares clean
+        void clear() noexcept {
+            sparse_.clear();
+            dense_.clear();
+            data_.clear();
+            added_.clear();
+            changed_.clear();
+            chunkRev_.clear();
+        }
+
+        void reserve(std::size_t n) {
+            dense_.reserve(n);
+            data_.reserve(n);
+            added_.reserve(n);
+            changed_.reserve(n);
+            chunkRev_.reserve((n + chunk_size - 1) / chunk_size);
+        }
+
+    private:
+        using Page = std::unique_ptr<std::uint32_t[]>;
+
+        [[nodiscard]] std::uint32_t slot(EntityID entity) const noexcept {
+            const auto index = entity_index(entity);
+            const auto page = index / page_size;
+            if (page >= sparse_.size() || !sparse_[page]) return npos;
+            const auto i = sparse_[page][index % page_size];
+            return (i != npos && dense_[i] == entity) ? i : npos;
+        }
+
+        void mark(std::size_t i) noexcept { chunkRev_[i / chunk_size] = ++rev_; }
+
+        std::uint32_t* assure_page(EntityIndex index) {
+            const auto page = index / page_size;
+            if (page >= sparse_.size()) sparse_.resize(page + 1);
+            if (!sparse_[page]) {
+                sparse_[page] = std::make_unique<std::uint32_t[]>(page_size);
+                std::fill_n(sparse_[page].get(), page_size, npos);
+            }
+            return sparse_[page].get();
+        }
+
+        std::vector<Page>     sparse_;
+        std::vector<EntityID> dense_;
+        std::vector<T>        data_;
+        std::vector<std::uint64_t> added_;    // tick of add, per dense slot
+        std::vector<std::uint64_t> changed_;  // tick of last add/write, per dense slot
+        std::vector<std::uint64_t> chunkRev_; // revision per chunk_size dense slots
+        std::uint64_t              rev_{ 0 };
+    };
 
     /// Underlying storage:
-    ///   map EntityID → ( map type_index → erased shared_ptr )
-    using ComponentStorage =
-        std::unordered_map<EntityID,
-        std::unordered_map<std::type_index, std::shared_ptr<void>>>;
+    ///   map type_index → ComponentPool<T> (one hash per call, not per entity)
+    class ComponentStorage {
+    public:
+        template<typename T>
+        [[nodiscard]] ComponentPool<T>& pool() {
+            auto& slot = pools_[std::type_index(typeid(T))];
+            if (!slot) slot = std::make_unique<ComponentPool<T>>();
+            return *static_cast<ComponentPool<T>*>(slot.get());
+        }
+
+        template<typename T>
+        [[nodiscard]] ComponentPool<T>* find_pool() noexcept {
+            auto it = pools_.find(std::type_index(typeid(T)));
+            return it != pools_.end() ? static_cast<ComponentPool<T>*>(it->second.get()) : nullptr;
+        }
+
+        template<typename T>
+        [[nodiscard]] const ComponentPool<T>* find_pool() const noexcept {
+            auto it = pools_.find(std::type_index(typeid(T)));
+            return it != pools_.end() ? static_cast<const ComponentPool<T>*>(it->second.get()) : nullptr;
+        }
+
+        /// drop `entity` from every pool
+        void remove_all(EntityID entity) {
+            for (auto& [type, p] : pools_) p->remove(entity);
+        }
+
+        void clear() noexcept { pools_.clear(); }
+
+    private:
+        std::unordered_map<std::type_index, std::unique_ptr<IComponentPool>> pools_;
+    };
 
     /**
      * add_component
      *   - storage: your global ComponentStorage
      *   - entity:  the ID
      *   - comp:    the new component (by value or moveable)
+     *   - tick:    the owner's current tick, stamped as added/changed
      */
     template<typename T>
     inline void add_component(ComponentStorage& storage,
         EntityID entity,
-        T comp)
+        T comp,
+        std::uint64_t tick)
     {
-        storage[entity][std::type_index(typeid(T))]
-            = std::make_shared<T>(std::move(comp));
+        storage.pool<T>().emplace_at(tick, entity, std::move(comp));
     }
 
     /**
@@ -65,9 +347,8 @@ namespace almondnamespace::ecs
     inline bool has_component(ComponentStorage const& storage,
         EntityID entity)
     {
-        auto it = storage.find(entity);
-        return it != storage.end()
-            && it->second.count(std::type_index(typeid(T))) > 0;
+        auto* p = storage.find_pool<T>();
+        return p && p->contains(entity);
     }
 
     /**
@@ -81,8 +362,7 @@ namespace almondnamespace::ecs
         EntityID entity)
     {
         assert(has_component<T>(storage, entity) && "Component not found!");
-        auto& ptr = storage[entity][std::type_index(typeid(T))];
-        return *static_cast<T*>(ptr.get());
+        return storage.pool<T>().get(entity);
     }
 
     /**
@@ -95,9 +375,8 @@ namespace almondnamespace::ecs
     inline void remove_component(ComponentStorage& storage,
         EntityID entity)
     {
-        auto it = storage.find(entity);
-        if (it != storage.end()) {
-            it->second.erase(std::type_index(typeid(T)));
+        if (auto* p = storage.find_pool<T>()) {
+            p->remove(entity);
         }
     }
 
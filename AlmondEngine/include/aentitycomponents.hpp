@@ -40,11 +40,14 @@ namespace almondnamespace::ecs {
     struct Velocity { float dx{ 0 }, dy{ 0 }; };
 
     // ─── History ──────────────────────────────────────────────────────────
-    // Each entity that needs rewind support keeps its past states here
-   // struct History { std::vector<std::pair<float, float>> states; };
+    // Each entity that needs rewind support keeps its past states in a
+    // bounded ring: see History in aentityhistory.hpp
 
     // ─── LoggerComponent ─────────────────────────────────────────────────
-    // Stores per‑entity logging preferences (file, level, clock pointer)
+    // Stores per‑entity logging preferences (file, level, clock pointer).
+    // Legacy: nothing in the engine reads it any more, ECS logging goes
+    // through the journal to the registry's Logger. Only the deprecated
+    // spawn_entity(R, logfile, lvl, clock) overload still attaches it.
     struct LoggerComponent {
         std::string       file;
         LogLevel          level{ LogLevel::INFO };
@@ -60,12 +63,12 @@ namespace almondnamespace::ecs {
 //// define registry with the components you use
 //using Reg = almondnamespace::ecs::reg_ex<
 //    almondnamespace::ecs::Position,
-//    almondnamespace::ecs::History,
-//    almondnamespace::ecs::LoggerComponent>;
+//    almondnamespace::ecs::History>;
 //
-//Reg R = almondnamespace::ecs::make_registry();
+//Reg R = almondnamespace::ecs::make_registry<almondnamespace::ecs::Position,
+//    almondnamespace::ecs::History>(&log, &clock);
 //
 //// spawn/move/rewind
-//auto id = almondnamespace::ecs::spawn_entity(R, "engine.log", LogLevel::Info, clock);
+//auto id = almondnamespace::ecs::spawn_entity(R);
 //almondnamespace::ecs::move_entity(R, id, 1.0f, 0.0f);
 //almondnamespace::ecs::rewind_entity(R, id);
\ No newline at end of file
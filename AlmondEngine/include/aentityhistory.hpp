@@ -22,81 +22,156 @@
 #pragma once
 
 #include "aplatform.hpp"      // must always come first
-#include "alogger.hpp"        // Logger
-#include "arobusttime.hpp"    // almondnamespace::time::RobustTime
+#include "aentitycomponentmanager.hpp"  // EntityID
 
-#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
-#include <mutex>
-#include <format>
 
 namespace almondnamespace::ecs
 {
-    /// History container: map from EntityID → list of past (x,y) states
-    using History = std::unordered_map<EntityID, std::vector<std::pair<float, float>>>;
+    /**
+     * History
+     *   Per‑entity time‑travel component: a fixed‑capacity ring of the last
+     *   N (x,y) states. Samples are stored as int16 offsets from a per‑entity
+     *   anchor in steps of `quantum` (4 bytes per tick instead of 8), so the
+     *   memory cap is exactly capacity * 4 bytes and any of the last N states
+     *   is one index away. A sample outside the anchor's ±32767·quantum range
+     *   re‑centres the anchor in place (O(capacity), no allocation); retained
+     *   states that no longer fit are dropped, so only a jump larger than the
+     *   range shortens the rewindable window.
+     *   The default quantum of 1/8 unit covers ±4095 units around the anchor,
+     *   enough for pixel‑space Positions on any screen; use quantum_for() to
+     *   size it for other coordinate ranges.
+     *   No locking: each entity owns its History.
+     */
+    class History {
+    public:
+        static constexpr std::uint32_t default_capacity = 64;
+        static constexpr float         default_quantum = 1.0f / 8.0f;
+
+        // finest quantum whose offsets still reach ±maxOffset
+        [[nodiscard]] static constexpr float quantum_for(float maxOffset) noexcept {
+            return maxOffset > 0 ? maxOffset / static_cast<float>(std::numeric_limits<std::int16_t>::max())
+                                 : default_quantum;
+        }
+
+        explicit History(std::uint32_t capacity = default_capacity, float quantum = default_quantum)
+            : samples_(static_cast<std::size_t>(std::max<std::uint32_t>(capacity, 1)) * 2),
+              quantum_(quantum), invQuantum_(1.0f / quantum) {
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return count_; }
+        [[nodiscard]] std::size_t capacity() const noexcept { return samples_.size() / 2; }
+        [[nodiscard]] bool        empty() const noexcept { return count_ == 0; }
+        [[nodiscard]] std::size_t memory_bytes() const noexcept { return samples_.size() * sizeof(std::int16_t); }
+
+        void clear() noexcept { count_ = 0; }
+
+        // push the newest state, overwriting the oldest once full
+        void record(float x, float y) {
+            if (count_ == 0) {
+                anchorX_ = x;
+                anchorY_ = y;
+            }
+            else if (!fits(x, y)) {
+                rebase(x, y);
+            }
+            head_ = (head_ + 1) % capacity();
+            store(head_, x, y);
+            count_ = std::min(count_ + 1, capacity());
+        }
+
+        // state `stepsBack` ticks ago (0 = newest); O(1)
+        bool sample(std::size_t stepsBack, float& x, float& y) const noexcept {
+            if (stepsBack >= count_) return false;
+            load(slot(stepsBack), x, y);
+            return true;
+        }
+
+        // drop the `steps` newest states and return the one now newest‑but‑
+        // rewound‑to, i.e. the state `steps - 1` ticks back; O(1)
+        bool rewind(std::size_t steps, float& x, float& y) noexcept {
+            if (steps == 0 || steps > count_) return false;
+            load(slot(steps - 1), x, y);
+            head_ = slot(steps);
+            count_ -= steps;
+            return true;
+        }
+
+    private:
+        static constexpr float range = static_cast<float>(std::numeric_limits<std::int16_t>::max());
+
+        [[nodiscard]] std::size_t slot(std::size_t stepsBack) const noexcept {
+            const auto cap = capacity();
+            return (head_ + cap - (stepsBack % cap)) % cap;
+        }
+
+        [[nodiscard]] bool fits(float x, float y) const noexcept {
+            return std::abs((x - anchorX_) * invQuantum_) <= range
+                && std::abs((y - anchorY_) * invQuantum_) <= range;
+        }
+
+        void store(std::size_t i, float x, float y) noexcept {
+            samples_[i * 2 + 0] = static_cast<std::int16_t>(std::lround((x - anchorX_) * invQuantum_));
+            samples_[i * 2 + 1] = static_cast<std::int16_t>(std::lround((y - anchorY_) * invQuantum_));
+        }
+
+        void load(std::size_t i, float& x, float& y) const noexcept {
+            load(i, anchorX_, anchorY_, x, y);
+        }
+
+        void load(std::size_t i, float ax, float ay, float& x, float& y) const noexcept {
+            x = ax + samples_[i * 2 + 0] * quantum_;
+            y = ay + samples_[i * 2 + 1] * quantum_;
+        }
+
+        // re‑centre on the incoming state, rewriting the newest samples that
+        // still fit in place. The new anchor stays on the old quantum grid, so
+        // re‑encoding a kept sample is exact.
+        void rebase(float x, float y) noexcept {
+            const float oldX = anchorX_, oldY = anchorY_;
+            anchorX_ = oldX + std::round((x - oldX) * invQuantum_) * quantum_;
+            anchorY_ = oldY + std::round((y - oldY) * invQuantum_) * quantum_;
+            std::size_t kept = 0;
+            for (; kept < count_; ++kept) {
+                float sx, sy;
+                load(slot(kept), oldX, oldY, sx, sy);
+                if (!fits(sx, sy)) break;
+                store(slot(kept), sx, sy);
+            }
+            count_ = kept;
+        }
+
+        std::vector<std::int16_t> samples_;   // interleaved x,y offsets
+        float                     anchorX_{ 0 }, anchorY_{ 0 };
+        float                     quantum_;
+        float                     invQuantum_;
+        std::size_t               head_{ 0 };
+        std::size_t               count_{ 0 };
+    };
 
     /**
      * save_state
-     *   Record a new (x,y) snapshot for entity `id`.
-     *   Logs the action via `logger` and `clock`.
+     *   Record a new (x,y) snapshot; allocation‑free after construction.
+     *   O(1), except when a large jump re‑centres the anchor (O(capacity)).
      */
-    inline void save_state(History& history,
-        EntityID id,
-        float x,
-        float y,
-        Logger& logger)
+    inline void save_state(History& history, float x, float y)
     {
-        static std::mutex mtx;
-        {
-            std::lock_guard lock(mtx);
-            history[id].emplace_back(x, y);
-        }
-        logger.log(std::format(
-            "[ECS] Saved state for EntityID {} at {} -> ({:.2f}, {:.2f})",
-            id,
-            time::getCurrentTimeString(),
-            x, y
-        ));
+        history.record(x, y);
     }
 
     /**
      * rewind_state
-     *   Rewind one step for entity `id`.
-     *   Returns true if successful (and outputs x,y), false if no history.
-     *   Logs the action via `logger` and `clock`.
+     *   Rewind `steps` ticks (default one). Returns true and outputs x,y if
+     *   that far back is still retained, false otherwise.
      */
-    inline bool rewind_state(History& history,
-        EntityID id,
-        float& x,
-        float& y,
-        Logger& logger)
+    inline bool rewind_state(History& history, float& x, float& y, std::size_t steps = 1)
     {
-        static std::mutex mtx;
-        bool ok = false;
-        {
-            std::lock_guard lock(mtx);
-            auto it = history.find(id);
-            if (it != history.end() && it->second.size() > 1) {
-                it->second.pop_back();
-                auto const& prev = it->second.back();
-                x = prev.first;
-                y = prev.second;
-                ok = true;
-            }
-        }
-        if (ok) {
-            logger.log(std::format(
-                "[ECS] EntityID {} rewound to ({:.2f}, {:.2f}) at {}",
-                id, x, y, time::getCurrentTimeString()
-            ));
-        }
-        else {
-            logger.log(std::format(
-                "[ECS] EntityID {} rewind failed (no history) at {}",
-                id, time::getCurrentTimeString()
-            ));
-        }
-        return ok;
+        return history.rewind(steps, x, y);
     }
 
 } // namespace almondnamespace::ecs
@@ -23,12 +23,20 @@
 
 #include "aplatform.hpp"      // Must always come first for platform defines
 
+#include "amemorytracker.hpp" // MemTagScope
+#include "aallocator.hpp"     // mem::shared_pool_resource
+
 #include <array>
+#include <cstddef>
 #include <atomic>
+#include <cassert>
 #include <cstdint>
 #include <functional>
+#include <memory_resource>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>       // std::move
 #include <vector>
@@ -74,30 +82,311 @@ namespace almondnamespace::events {
     }
 
     // ─── Lock‑free MPSC ring buffer ───────────────────────────────────
-    template<std::size_t N = 4096>
-    struct mpsc_ring {
+    // Per‑slot sequence numbers (same scheme as MPMCQueue) so the consumer
+    // never reads a slot before its producer has finished writing it.
+    // What a producer does when the ring is full is a compile‑time policy:
+    enum class OverflowPolicy : uint8_t {
+        DropNewest,   // reject the new event, count it
+        DropOldest,   // evict the oldest queued event, count it
+        Block,        // sleep on the slot (atomic::wait) until the consumer frees it
+        Grow          // spill into a locked overflow list, nothing is lost
+    };
+
+    // Grow by default: a producer that is also the consumer (post and pump
+    // on one thread) would wait forever under Block, so Block is opt-in
+    template<typename T, std::size_t N, OverflowPolicy P = OverflowPolicy::Grow>
+    struct basic_mpsc_ring {
         static_assert((N& (N - 1)) == 0,
             "Capacity must be a power of two");
-        std::array<Event, N>          buf{};
-        std::atomic<std::size_t>     head{ 0 };
-        std::atomic<std::size_t>     tail{ 0 };
-
-        bool enqueue(const Event& e) noexcept {
-            auto h = head.fetch_add(1, std::memory_order_acq_rel);
-            while (h - tail.load(std::memory_order_acquire) >= N) {}  // spin if full
-            buf[h & (N - 1)] = e;
+
+        basic_mpsc_ring() noexcept {
+            for (std::size_t i = 0; i < N; ++i)
+                buf[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        basic_mpsc_ring(const basic_mpsc_ring&) = delete;
+        basic_mpsc_ring& operator=(const basic_mpsc_ring&) = delete;
+
+        bool enqueue(const T& e) {
+            for (;;) {
+                std::size_t pos = head.load(std::memory_order_relaxed);
+                for (;;) {
+                    if constexpr (P == OverflowPolicy::Grow) {
+                        if (spilling.load(std::memory_order_acquire)) return spill(e);
+                    }
+                    Slot& slot = buf[pos & (N - 1)];
+                    const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+                    const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                    if (dif == 0) {
+                        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            slot.value = e;
+                            slot.seq.store(pos + 1, std::memory_order_release);
+                            const std::size_t t = tail.load(std::memory_order_relaxed);
+                            if (pos + 1 > t) note_size(pos + 1 - t);
+                            return true;
+                        }
+                    }
+                    else if (dif < 0) {
+                        // full
+                        if constexpr (P == OverflowPolicy::DropNewest) {
+                            dropCount.fetch_add(1, std::memory_order_relaxed);
+                            return false;
+                        }
+                        else if constexpr (P == OverflowPolicy::DropOldest) {
+                            T discard;
+                            if (dequeue(discard)) dropCount.fetch_add(1, std::memory_order_relaxed);
+                            break;
+                        }
+                        else if constexpr (P == OverflowPolicy::Block) {
+                            waiters.fetch_add(1, std::memory_order_seq_cst);
+                            slot.seq.wait(seq, std::memory_order_acquire);
+                            waiters.fetch_sub(1, std::memory_order_relaxed);
+                            break;
+                        }
+                        else {
+                            return spill(e);
+                        }
+                    }
+                    else {
+                        pos = head.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        bool dequeue(T& out) {
+            std::size_t pos = tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = buf[pos & (N - 1)];
+                const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+                const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (dif == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        out = std::move(slot.value);
+                        slot.seq.store(pos + N, std::memory_order_seq_cst);
+                        if constexpr (P == OverflowPolicy::Block) {
+                            if (waiters.load(std::memory_order_seq_cst) != 0) slot.seq.notify_all();
+                        }
+                        return true;
+                    }
+                }
+                else if (dif < 0) {
+                    // empty (or head slot still being written). Spilled events
+                    // are newer than anything their producer put in the ring,
+                    // so only take them once no claimed slot is left behind
+                    if constexpr (P == OverflowPolicy::Grow) {
+                        if (head.load(std::memory_order_acquire) == pos) {
+                            if (unspill(out, pos)) return true;
+                            if (head.load(std::memory_order_acquire) == pos) return false;
+                            pos = tail.load(std::memory_order_relaxed);   // ring refilled meanwhile
+                            continue;
+                        }
+                    }
+                    return false;
+                }
+                else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t size_approx() const noexcept {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            return h >= t ? h - t : 0;
+        }
+
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept { return N; }
+        [[nodiscard]] std::size_t dropped()    const noexcept { return dropCount.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::size_t high_water() const noexcept { return highWater.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> seq{ 0 };
+            T                        value{};
+        };
+
+        void note_size(std::size_t n) noexcept {
+            std::size_t hw = highWater.load(std::memory_order_relaxed);
+            while (n > hw && !highWater.compare_exchange_weak(hw, n, std::memory_order_relaxed)) {}
+        }
+
+        bool spill(const T& e) {
+            std::lock_guard lock(spillLock);
+            spillList.push_back(e);
+            spilling.store(true, std::memory_order_release);
+            note_size(N + spillList.size());
             return true;
         }
-        bool dequeue(Event& out) noexcept {
-            auto t = tail.load(std::memory_order_relaxed);
-            if (t == head.load(std::memory_order_acquire)) return false; // empty
-            out = std::move(buf[t & (N - 1)]);
-            tail.store(t + 1, std::memory_order_release);
+
+        // `pos` is the tail the caller found empty. Re-checked under the lock:
+        // a producer publishes its ring events before it pushes a spilled
+        // one, so anything it left in the ring is visible here and goes first
+        bool unspill(T& out, std::size_t pos) {
+            if (!spilling.load(std::memory_order_acquire)) return false;
+            std::lock_guard lock(spillLock);
+            if (head.load(std::memory_order_acquire) != pos) return false;
+            if (spillHead == spillList.size()) {
+                spillList.clear();
+                spillHead = 0;
+                spilling.store(false, std::memory_order_release);
+                return false;
+            }
+            out = std::move(spillList[spillHead++]);
             return true;
         }
+
+        std::array<Slot, N>                    buf{};
+        alignas(64) std::atomic<std::size_t>   head{ 0 };
+        alignas(64) std::atomic<std::size_t>   tail{ 0 };
+        alignas(64) std::atomic<std::size_t>   waiters{ 0 };
+        std::atomic<std::size_t>               dropCount{ 0 };
+        std::atomic<std::size_t>               highWater{ 0 };
+
+        // OverflowPolicy::Grow only; the spill list allocates from the
+        // shared size‑class pools rather than the global heap
+        std::atomic<bool>                      spilling{ false };
+        std::mutex                             spillLock;
+        std::pmr::vector<T>                    spillList{ &mem::shared_pool_resource() };
+        std::size_t                            spillHead = 0;
+    };
+
+    template<std::size_t N = 4096>
+    using mpsc_ring = basic_mpsc_ring<Event, N>;
+
+    // ─── Typed events (POD, no heap) ──────────────────────────────────
+    struct MouseMoveEvent   { float x{ 0 }, y{ 0 }; };
+    struct MouseButtonEvent { uint8_t button{ 0 }; bool pressed{ true }; float x{ 0 }, y{ 0 }; };
+    struct KeyEvent         { uint32_t key{ 0 }; bool pressed{ true }; };
+    struct TextInputEvent   { char32_t text{ 0 }; };
+
+    template<typename E>
+    concept TypedEvent = std::is_trivially_copyable_v<E> && std::is_default_constructible_v<E>;
+
+    namespace _detail {
+        [[nodiscard]] constexpr uint64_t fnv1a(std::string_view s) noexcept {
+            uint64_t h = 14695981039346656037ull;
+            for (char c : s) { h ^= static_cast<uint8_t>(c); h *= 1099511628211ull; }
+            return h;
+        }
+
+        template<typename E>
+        [[nodiscard]] constexpr std::string_view type_signature() noexcept {
+#if defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
+#endif
+        }
+    }
+
+    // stable per‑type id, usable in switch/case and serialized streams
+    template<typename E>
+    inline constexpr uint64_t event_type_id = _detail::fnv1a(_detail::type_signature<E>());
+
+    // ─── Per‑type channel: its own ring + plain function subscribers ──
+    inline constexpr std::size_t default_channel_capacity = 1024;
+
+    // what a full channel does. post() and pump() usually share the game
+    // thread, so the default must never wait on the consumer: overflow
+    // spills (Grow). Block is opt‑in, only for channels whose producers run
+    // on other threads; mouse‑move storms only need the latest samples.
+    template<typename E>
+    inline constexpr OverflowPolicy channel_overflow_policy = OverflowPolicy::Grow;
+
+    template<>
+    inline constexpr OverflowPolicy channel_overflow_policy<MouseMoveEvent> = OverflowPolicy::DropOldest;
+
+    template<TypedEvent E>
+    struct Subscriber {
+        void (*plain)(const E&) = nullptr;            // free function / captureless lambda
+        void (*bound)(void*, const E&) = nullptr;     // trampoline + context
+        void* ctx = nullptr;
+
+        void operator()(const E& e) const { plain ? plain(e) : bound(ctx, e); }
     };
 
+    template<TypedEvent E>
+    struct Channel {
+        basic_mpsc_ring<E, default_channel_capacity, channel_overflow_policy<E>> queue;
+        std::vector<Subscriber<E>>                   subscribers;
+
+        // not noexcept: a throwing subscriber propagates to the pumping caller
+        std::size_t pump() {
+            std::size_t n = 0;
+            E e;
+            while (queue.dequeue(e)) {
+                for (auto& s : subscribers) s(e);
+                ++n;
+            }
+            return n;
+        }
+    };
+
+    namespace _detail {
+        using ChannelPump = std::size_t(*)();
+        inline constexpr std::size_t max_channels = 64;
+
+        // append‑only table, so pump_typed never takes a lock
+        struct ChannelTable {
+            std::array<std::atomic<ChannelPump>, max_channels> pumps{};
+            std::atomic<std::size_t>                           count{ 0 };
+            std::mutex                                         writeLock;
+        };
+
+        inline ChannelTable& channel_table() {
+            static ChannelTable t;
+            return t;
+        }
+
+        inline bool add_channel_pump(ChannelPump fn) {
+            auto& t = channel_table();
+            std::lock_guard lock(t.writeLock);
+            const std::size_t i = t.count.load(std::memory_order_relaxed);
+            assert(i < max_channels && "too many typed event channels");
+            if (i >= max_channels) return false;
+            t.pumps[i].store(fn, std::memory_order_relaxed);
+            t.count.store(i + 1, std::memory_order_release);
+            return true;
+        }
+    }
+
+    template<TypedEvent E>
+    inline Channel<E>& channel() {
+        static Channel<E> ch;
+        static const bool registered = _detail::add_channel_pump(+[]() { return channel<E>().pump(); });
+        (void)registered;
+        return ch;
+    }
+
+    // post a typed event (any thread)
+    template<TypedEvent E>
+    inline bool post(const E& e) { return channel<E>().queue.enqueue(e); }
+
+    // subscribe a free function / captureless lambda
+    template<TypedEvent E>
+    inline void subscribe(void (*fn)(const E&)) { channel<E>().subscribers.push_back({ fn, nullptr, nullptr }); }
+
+    // subscribe with a context pointer (e.g. `this`)
+    template<TypedEvent E>
+    inline void subscribe(void (*fn)(void*, const E&), void* ctx) { channel<E>().subscribers.push_back({ nullptr, fn, ctx }); }
+
+    template<TypedEvent E>
+    inline void unsubscribe_all() { channel<E>().subscribers.clear(); }
+
+    // dispatch every typed channel on the calling thread
+    inline std::size_t pump_typed() {
+        auto& t = _detail::channel_table();
+        const std::size_t count = t.count.load(std::memory_order_acquire);
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count; ++i)
+            n += t.pumps[i].load(std::memory_order_relaxed)();
+        return n;
+    }
+
     // ─── Globals (header‑only) + public API ───────────────────────────
+    // Compatibility shim: string‑map Events still queue and reach the
+    // registered callbacks; pump() also drains the typed channels.
     inline mpsc_ring<>                    g_queue;
     using Callback = std::function<void(const Event&)>;
     inline std::vector<Callback>& g_callbacks() {
@@ -106,8 +395,12 @@ namespace almondnamespace::events {
     }
 
     inline void register_callback(Callback cb) { g_callbacks().push_back(std::move(cb)); }
-    inline void push_event(const Event& e) noexcept { g_queue.enqueue(e); }
-    inline void pump() noexcept {
+    inline bool push_event(const Event& e) {
+        mem::MemTagScope memTag(mem::MemTag::Events);
+        return g_queue.enqueue(e);
+    }
+    inline void pump() {
+        pump_typed();
         Event e;
         while (g_queue.dequeue(e))
             for (auto& fn : g_callbacks()) fn(e);
@@ -0,0 +1,293 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+// amemorytracker.hpp
+#pragma once
+
+#include "aplatform.hpp"   // must always come first
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
+
+// Allocation tracking, bucketed by subsystem tag.
+//
+//  ▸ tracked_resource : pmr wrapper that charges every allocation to one tag
+//  ▸ MemTagScope      : sets the tag the global operator new hook charges on this thread
+//  ▸ snapshot_memory / diff_memory / write_memory_report : inspection
+//
+// tracked_resource always counts. The global operator new/delete hook is
+// opt-in: define ALMOND_TRACK_ALLOCATIONS (see aengineconfig.hpp) and it is
+// compiled into amemorytracker.cpp. Call mem::end_tracking_frame() once per
+// frame so the per-frame counters roll over.
+
+namespace almondnamespace::mem {
+
+    enum class MemTag : std::uint8_t {
+        Untagged,
+        ECS,
+        Atlas,
+        Events,
+        Render,
+        Net,
+        Scripting,
+        Count
+    };
+
+    inline constexpr std::size_t mem_tag_count = static_cast<std::size_t>(MemTag::Count);
+
+    constexpr std::string_view to_string(MemTag tag) noexcept {
+        switch (tag) {
+        case MemTag::Untagged:  return "Untagged";
+        case MemTag::ECS:       return "ECS";
+        case MemTag::Atlas:     return "Atlas";
+        case MemTag::Events:    return "Events";
+        case MemTag::Render:    return "Render";
+        case MemTag::Net:       return "Net";
+        case MemTag::Scripting: return "Scripting";
+        default:                return "?";
+        }
+    }
+
+    struct tag_stats {
+        std::int64_t  live_bytes = 0;
+        std::int64_t  peak_bytes = 0;
+        std::uint64_t allocations = 0;       // since start
+        std::uint64_t frees = 0;
+        std::uint64_t bytes_allocated = 0;   // since start
+        std::uint64_t frame_allocations = 0; // during the last completed frame
+        std::uint64_t frame_bytes = 0;
+    };
+
+    struct memory_snapshot {
+        std::uint64_t                          frame = 0;
+        std::array<tag_stats, mem_tag_count>   tags{};
+
+        const tag_stats& operator[](MemTag t) const noexcept { return tags[static_cast<std::size_t>(t)]; }
+    };
+
+    /// what happened between two snapshots
+    struct memory_delta {
+        struct entry {
+            std::int64_t  live_bytes = 0;
+            std::uint64_t allocations = 0;
+            std::uint64_t frees = 0;
+            std::uint64_t bytes_allocated = 0;
+        };
+
+        std::uint64_t                      frames = 0;
+        std::array<entry, mem_tag_count>   tags{};
+
+        const entry& operator[](MemTag t) const noexcept { return tags[static_cast<std::size_t>(t)]; }
+    };
+
+    namespace _detail {
+        // one cache line per tag so unrelated subsystems do not false-share
+        struct alignas(64) tag_counters {
+            std::atomic<std::int64_t>  live{ 0 };
+            std::atomic<std::int64_t>  peak{ 0 };
+            std::atomic<std::uint64_t> allocs{ 0 };
+            std::atomic<std::uint64_t> frees{ 0 };
+            std::atomic<std::uint64_t> bytes{ 0 };
+            std::atomic<std::uint64_t> frameBaseAllocs{ 0 };
+            std::atomic<std::uint64_t> frameBaseBytes{ 0 };
+            std::atomic<std::uint64_t> lastFrameAllocs{ 0 };
+            std::atomic<std::uint64_t> lastFrameBytes{ 0 };
+        };
+
+        // constant-initialised: the operator new hook may run before main
+        inline constinit std::array<tag_counters, mem_tag_count> g_tag_counters{};
+        inline constinit std::atomic<std::uint64_t>              g_tracked_frame{ 0 };
+
+        inline thread_local MemTag t_current_tag = MemTag::Untagged;
+        inline thread_local int    t_hook_suppressed = 0;   // >0 inside a tracked_resource
+
+        inline tag_counters& counters(MemTag tag) noexcept {
+            const auto i = static_cast<std::size_t>(tag);
+            return g_tag_counters[i < mem_tag_count ? i : 0];
+        }
+    }
+
+    inline void record_alloc(MemTag tag, std::size_t n) noexcept {
+        auto& c = _detail::counters(tag);
+        const auto bytes = static_cast<std::int64_t>(n);
+        const auto live = c.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto peak = c.peak.load(std::memory_order_relaxed);
+        while (live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        c.allocs.fetch_add(1, std::memory_order_relaxed);
+        c.bytes.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    inline void record_free(MemTag tag, std::size_t n) noexcept {
+        auto& c = _detail::counters(tag);
+        c.live.fetch_sub(static_cast<std::int64_t>(n), std::memory_order_relaxed);
+        c.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// the tag the global hook charges on this thread
+    inline MemTag current_mem_tag() noexcept { return _detail::t_current_tag; }
+
+    /// charges global-heap allocations on this thread to `tag` until scope exit
+    class MemTagScope {
+    public:
+        explicit MemTagScope(MemTag tag) noexcept : prev_{ _detail::t_current_tag } {
+            _detail::t_current_tag = tag;
+        }
+        ~MemTagScope() { _detail::t_current_tag = prev_; }
+
+        MemTagScope(const MemTagScope&) = delete;
+        MemTagScope& operator=(const MemTagScope&) = delete;
+
+    private:
+        MemTag prev_;
+    };
+
+    /// pmr wrapper: forwards to `upstream` and charges everything to one tag
+    class tracked_resource final : public std::pmr::memory_resource {
+    public:
+        explicit tracked_resource(MemTag tag,
+            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+            : tag_{ tag }, upstream_{ upstream } {
+        }
+
+        MemTag                     tag() const noexcept { return tag_; }
+        std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+    private:
+        // the global hook must not count the same bytes a second time
+        struct suppress_hook {
+            suppress_hook() noexcept { ++_detail::t_hook_suppressed; }
+            ~suppress_hook() { --_detail::t_hook_suppressed; }
+        };
+
+        void* do_allocate(std::size_t n, std::size_t align) override {
+            void* p;
+            {
+                suppress_hook guard;
+                p = upstream_->allocate(n, align);
+            }
+            record_alloc(tag_, n);
+            return p;
+        }
+        void do_deallocate(void* p, std::size_t n, std::size_t align) override {
+            {
+                suppress_hook guard;
+                upstream_->deallocate(p, n, align);
+            }
+            record_free(tag_, n);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+            return this == &o;
+        }
+
+        MemTag                     tag_;
+        std::pmr::memory_resource* upstream_;
+    };
+
+    /// shared tracked_resource for `tag`, backed by new/delete
+    inline tracked_resource& tagged_resource(MemTag tag) noexcept {
+        static tracked_resource resources[mem_tag_count] = {
+            tracked_resource{ MemTag::Untagged }, tracked_resource{ MemTag::ECS },
+            tracked_resource{ MemTag::Atlas },    tracked_resource{ MemTag::Events },
+            tracked_resource{ MemTag::Render },   tracked_resource{ MemTag::Net },
+            tracked_resource{ MemTag::Scripting },
+        };
+        const auto i = static_cast<std::size_t>(tag);
+        return resources[i < mem_tag_count ? i : 0];
+    }
+
+    /// closes the current frame: per-frame counters report this frame from now on
+    inline void end_tracking_frame() noexcept {
+        for (auto& c : _detail::g_tag_counters) {
+            const auto allocs = c.allocs.load(std::memory_order_relaxed);
+            const auto bytes = c.bytes.load(std::memory_order_relaxed);
+            c.lastFrameAllocs.store(allocs - c.frameBaseAllocs.exchange(allocs, std::memory_order_relaxed), std::memory_order_relaxed);
+            c.lastFrameBytes.store(bytes - c.frameBaseBytes.exchange(bytes, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        _detail::g_tracked_frame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline memory_snapshot snapshot_memory() noexcept {
+        memory_snapshot s;
+        s.frame = _detail::g_tracked_frame.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < mem_tag_count; ++i) {
+            const auto& c = _detail::g_tag_counters[i];
+            auto& t = s.tags[i];
+            t.live_bytes = c.live.load(std::memory_order_relaxed);
+            t.peak_bytes = c.peak.load(std::memory_order_relaxed);
+            t.allocations = c.allocs.load(std::memory_order_relaxed);
+            t.frees = c.frees.load(std::memory_order_relaxed);
+            t.bytes_allocated = c.bytes.load(std::memory_order_relaxed);
+            t.frame_allocations = c.lastFrameAllocs.load(std::memory_order_relaxed);
+            t.frame_bytes = c.lastFrameBytes.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    /// `after` minus `before`
+    [[nodiscard]] inline memory_delta diff_memory(const memory_snapshot& before, const memory_snapshot& after) noexcept {
+        memory_delta d;
+        d.frames = after.frame - before.frame;
+        for (std::size_t i = 0; i < mem_tag_count; ++i) {
+            const auto& a = before.tags[i];
+            const auto& b = after.tags[i];
+            d.tags[i] = { b.live_bytes - a.live_bytes, b.allocations - a.allocations,
+                          b.frees - a.frees, b.bytes_allocated - a.bytes_allocated };
+        }
+        return d;
+    }
+
+    inline void write_memory_report(std::ostream& os, const memory_snapshot& s) {
+        os << "[Memory] frame " << s.frame << "\n"
+           << std::left << std::setw(10) << "tag" << std::right
+           << std::setw(14) << "live" << std::setw(14) << "peak"
+           << std::setw(12) << "allocs" << std::setw(12) << "frees"
+           << std::setw(12) << "allocs/frm" << std::setw(14) << "bytes/frm" << "\n";
+        for (std::size_t i = 0; i < mem_tag_count; ++i) {
+            const auto& t = s.tags[i];
+            if (t.allocations == 0 && t.frees == 0) continue;
+            os << std::left << std::setw(10) << to_string(static_cast<MemTag>(i)) << std::right
+               << std::setw(14) << t.live_bytes << std::setw(14) << t.peak_bytes
+               << std::setw(12) << t.allocations << std::setw(12) << t.frees
+               << std::setw(12) << t.frame_allocations << std::setw(14) << t.frame_bytes << "\n";
+        }
+    }
+
+    inline void write_memory_report(std::ostream& os, const memory_delta& d) {
+        os << "[Memory] delta over " << d.frames << " frame(s)\n"
+           << std::left << std::setw(10) << "tag" << std::right
+           << std::setw(14) << "live" << std::setw(12) << "allocs"
+           << std::setw(12) << "frees" << std::setw(14) << "bytes" << "\n";
+        for (std::size_t i = 0; i < mem_tag_count; ++i) {
+            const auto& t = d.tags[i];
+            if (t.allocations == 0 && t.frees == 0) continue;
+            os << std::left << std::setw(10) << to_string(static_cast<MemTag>(i)) << std::right
+               << std::setw(14) << t.live_bytes << std::setw(12) << t.allocations
+               << std::setw(12) << t.frees << std::setw(14) << t.bytes_allocated << "\n";
+        }
+    }
+
+} // namespace almondnamespace::mem
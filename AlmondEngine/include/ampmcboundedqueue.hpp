@@ -22,14 +22,25 @@
  // ampmcboundedqueue.hpp
 #pragma once
 
+#include "aplatform.hpp"
+
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <cassert>
 
 namespace almondnamespace
 {
+    // Bounded lock-free MPMC queue (Vyukov sequence slots).
+    //  ▸ head_/tail_ and every slot sit on their own cache line
+    //  ▸ slots are raw storage: T is constructed on enqueue, destroyed on dequeue,
+    //    so T needs no default ctor and may be move-only
+    //  ▸ bulk ops claim a run of slots with a single CAS
+    //  ▸ wait_enqueue/wait_dequeue block on atomic::wait until space/data or close()
     template<typename T>
     class MPMCQueue {
     public:
@@ -37,87 +48,281 @@ namespace almondnamespace
         explicit MPMCQueue(size_t capacity)
             : capacity_(capacity),
             mask_(capacity - 1),
-            buffer_(static_cast<Node*>(operator new[](sizeof(Node)* capacity)))
+            buffer_(std::make_unique<Slot[]>(capacity))
         {
-            assert((capacity & mask_) == 0 && "capacity must be power of two");
-            for (size_t i = 0; i < capacity_; ++i) {
-                new(&buffer_[i]) Node{ i, T{} };
-            }
-            head_.store(0, std::memory_order_relaxed);
-            tail_.store(0, std::memory_order_relaxed);
+            assert(capacity != 0 && (capacity & mask_) == 0 && "capacity must be power of two");
+            for (size_t i = 0; i < capacity_; ++i)
+                buffer_[i].seq.store(i, std::memory_order_relaxed);
         }
 
         ~MPMCQueue() {
-            for (size_t i = 0; i < capacity_; ++i)
-                buffer_[i].~Node();
-            operator delete[](buffer_);
+            // single-threaded by now: every claimed slot is published
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            for (size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos)
+                buffer_[pos & mask_].ptr()->~T();
+        }
+
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+        // ─── single element ───────────────────────────────────────────
+        // A claimed slot must always be published, or consumers stall on it:
+        // a constructor that may throw runs into a local first, before the
+        // claim, and the value is then moved in (args are consumed even if
+        // the queue turns out to be full).
+        template<typename... Args>
+        bool try_emplace(Args&&... args) {
+            if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+                size_t pos;
+                Slot* slot = claim_push(pos);
+                if (!slot) return false; // queue full
+                new (slot->storage) T(std::forward<Args>(args)...);
+                publish_push(*slot, pos);
+                notify_consumers();
+                return true;
+            }
+            else {
+                static_assert(std::is_nothrow_move_constructible_v<T>,
+                    "MPMCQueue: T needs a noexcept move constructor to enqueue from a throwing constructor");
+                return try_emplace(T(std::forward<Args>(args)...));
+            }
+        }
+
+        bool enqueue(const T& item) { return try_emplace(item); }
+        bool enqueue(T&& item) { return try_emplace(std::move(item)); }
+
+        bool dequeue(T& item) {
+            size_t pos;
+            Slot* slot = claim_pop(pos);
+            if (!slot) return false; // queue empty
+            take(*slot, pos, item);
+            notify_producers();
+            return true;
+        }
+
+        // ─── bulk ─────────────────────────────────────────────────────
+        // Enqueues up to `count` items from `first` (pass std::make_move_iterator
+        // for move-only T); returns how many went in. One CAS per run of free slots.
+        template<typename It>
+        size_t enqueue_bulk(It first, size_t count) {
+            size_t done = 0;
+            if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)>) {
+                // claimed runs are filled after the CAS: only safe if that can't throw
+                for (; done < count && try_emplace(*first); ++done, ++first) {}
+                return done;
+            }
+            while (done < count) {
+                size_t pos = tail_.load(std::memory_order_relaxed);
+                size_t run = 0;
+                for (;;) {
+                    run = 0;
+                    while (run < count - done &&
+                        buffer_[(pos + run) & mask_].seq.load(std::memory_order_acquire) == pos + run)
+                        ++run;
+                    if (run == 0) {
+                        // stale pos, or really full
+                        const size_t seq = buffer_[pos & mask_].seq.load(std::memory_order_acquire);
+                        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) break;
+                        pos = tail_.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    if (tail_.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) break;
+                }
+                if (run == 0) break;
+                for (size_t i = 0; i < run; ++i, ++first) {
+                    Slot& slot = buffer_[(pos + i) & mask_];
+                    new (slot.storage) T(*first);
+                    publish_push(slot, pos + i);
+                }
+                done += run;
+            }
+            if (done) notify_consumers();
+            return done;
         }
 
-        bool enqueue(const T& item) {
-            Node* node;
-            size_t pos = tail_.load(std::memory_order_relaxed);
+        // Moves up to `maxCount` items into `out`; returns how many.
+        template<typename OutIt>
+        size_t dequeue_bulk(OutIt out, size_t maxCount) {
+            size_t done = 0;
+            while (done < maxCount) {
+                size_t pos = head_.load(std::memory_order_relaxed);
+                size_t run = 0;
+                for (;;) {
+                    run = 0;
+                    while (run < maxCount - done &&
+                        buffer_[(pos + run) & mask_].seq.load(std::memory_order_acquire) == pos + run + 1)
+                        ++run;
+                    if (run == 0) {
+                        const size_t seq = buffer_[pos & mask_].seq.load(std::memory_order_acquire);
+                        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) break;
+                        pos = head_.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    if (head_.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed)) break;
+                }
+                if (run == 0) break;
+                for (size_t i = 0; i < run; ++i) {
+                    Slot& slot = buffer_[(pos + i) & mask_];
+                    T* p = slot.ptr();
+                    *out = std::move(*p);
+                    ++out;
+                    p->~T();
+                    slot.seq.store(pos + i + capacity_, std::memory_order_seq_cst);
+                }
+                done += run;
+            }
+            if (done) notify_producers();
+            return done;
+        }
+
+        // ─── blocking ─────────────────────────────────────────────────
+        // Block until there is room; false only once the queue is closed.
+        template<typename... Args>
+        bool wait_enqueue(Args&&... args) {
+            if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+                // build once, so a retry after a full queue still has the value
+                return wait_enqueue(T(std::forward<Args>(args)...));
+            }
+            for (;;) {
+                if (closed_.load(std::memory_order_acquire)) return false;
+                const auto epoch = popEpoch_.load(std::memory_order_acquire);
+                pushWaiters_.fetch_add(1, std::memory_order_seq_cst);
+                if (try_emplace(std::forward<Args>(args)...)) {
+                    pushWaiters_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+                if (!closed_.load(std::memory_order_acquire))
+                    popEpoch_.wait(epoch, std::memory_order_acquire);
+                pushWaiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Block until an item arrives; false once the queue is closed and drained.
+        bool wait_dequeue(T& item) {
             for (;;) {
-                node = &buffer_[pos & mask_];
-                size_t seq = node->seq.load(std::memory_order_acquire);
-                intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+                const auto epoch = pushEpoch_.load(std::memory_order_acquire);
+                popWaiters_.fetch_add(1, std::memory_order_seq_cst);
+                if (dequeue(item)) {
+                    popWaiters_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+                const bool closed = closed_.load(std::memory_order_acquire);
+                if (!closed) pushEpoch_.wait(epoch, std::memory_order_acquire);
+                popWaiters_.fetch_sub(1, std::memory_order_relaxed);
+                if (closed) return dequeue(item);
+            }
+        }
+
+        // Wake every blocked caller; later waits return false instead of blocking.
+        // Non-blocking enqueue/dequeue keep working.
+        void close() noexcept {
+            closed_.store(true, std::memory_order_seq_cst);
+            pushEpoch_.fetch_add(1, std::memory_order_release);
+            pushEpoch_.notify_all();
+            popEpoch_.fetch_add(1, std::memory_order_release);
+            popEpoch_.notify_all();
+        }
+
+        bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+        // ─── observers ────────────────────────────────────────────────
+        bool empty() const {
+            return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+        }
+
+        // approximate under concurrency; exact when quiescent
+        size_t size() const noexcept {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            const auto n = static_cast<intptr_t>(tail - head);
+            return n < 0 ? 0 : (static_cast<size_t>(n) > capacity_ ? capacity_ : static_cast<size_t>(n));
+        }
+
+        size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<size_t> seq{ 0 };
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        Slot* claim_push(size_t& pos) {
+            pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot* slot = &buffer_[pos & mask_];
+                const size_t seq = slot->seq.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
                 if (dif == 0) {
                     if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
-                        break;
+                        return slot;
                 }
                 else if (dif < 0) {
-                    return false; // queue full
+                    return nullptr;
                 }
                 else {
                     pos = tail_.load(std::memory_order_relaxed);
                 }
             }
-            node->data = item;
-            node->seq.store(pos + 1, std::memory_order_release);
-            return true;
         }
 
-        bool dequeue(T& item) {
-            Node* node;
-            size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* claim_pop(size_t& pos) {
+            pos = head_.load(std::memory_order_relaxed);
             for (;;) {
-                node = &buffer_[pos & mask_];
-                size_t seq = node->seq.load(std::memory_order_acquire);
-                intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+                Slot* slot = &buffer_[pos & mask_];
+                const size_t seq = slot->seq.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
                 if (dif == 0) {
                     if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
-                        break;
+                        return slot;
                 }
                 else if (dif < 0) {
-                    return false; // queue empty
+                    return nullptr;
                 }
                 else {
                     pos = head_.load(std::memory_order_relaxed);
                 }
             }
-            item = std::move(node->data);
-            node->seq.store(pos + capacity_, std::memory_order_release);
-            return true;
         }
 
-        // Add this method to check if the queue is empty
-        bool empty() const {
-            return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+        // seq_cst so a waiter that registered before its last check is never
+        // missed by the waiter-count load in notify_*()
+        void publish_push(Slot& slot, size_t pos) noexcept {
+            slot.seq.store(pos + 1, std::memory_order_seq_cst);
         }
 
-    private:
-        struct Node {
-            std::atomic<size_t> seq;
-            T                    data;
-        };
+        void take(Slot& slot, size_t pos, T& item) {
+            T* p = slot.ptr();
+            item = std::move(*p);
+            p->~T();
+            slot.seq.store(pos + capacity_, std::memory_order_seq_cst);
+        }
 
-        const size_t     capacity_;
-        const size_t     mask_;
-        Node* buffer_;
-        std::atomic<size_t> head_;
-        std::atomic<size_t> tail_;
+        void notify_consumers() noexcept {
+            if (popWaiters_.load(std::memory_order_seq_cst) == 0) return;
+            pushEpoch_.fetch_add(1, std::memory_order_release);
+            pushEpoch_.notify_all();
+        }
 
-        // non‑copyable
-        MPMCQueue(const MPMCQueue&) = delete;
-        MPMCQueue& operator=(const MPMCQueue&) = delete;
+        void notify_producers() noexcept {
+            if (pushWaiters_.load(std::memory_order_seq_cst) == 0) return;
+            popEpoch_.fetch_add(1, std::memory_order_release);
+            popEpoch_.notify_all();
+        }
+
+        const size_t            capacity_;
+        const size_t            mask_;
+        std::unique_ptr<Slot[]> buffer_;
+
+        alignas(64) std::atomic<size_t> head_{ 0 };   // next dequeue position
+        alignas(64) std::atomic<size_t> tail_{ 0 };   // next enqueue position
+
+        // blocking waits only; producers/consumers just read the waiter counts
+        alignas(64) std::atomic<uint32_t> pushEpoch_{ 0 };
+        std::atomic<uint32_t>             popEpoch_{ 0 };
+        std::atomic<uint32_t>             pushWaiters_{ 0 };
+        std::atomic<uint32_t>             popWaiters_{ 0 };
+        std::atomic<bool>                 closed_{ false };
     };
 } // namespace almondnamespace
@@ -21,9 +21,156 @@
  **************************************************************/
 // almond_noheap_guard.hpp
 #pragma once
+
+#include "aplatform.hpp"   // must always come first
+
+#include "amemorytracker.hpp"
+
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+// NoAllocScope: runtime guard for hot paths that must not touch the heap.
+//
+//  {
+//      mem::NoAllocScope guard("render", mem::NoAllocAction::Assert);
+//      renderFrame();
+//  }   // logs every heap allocation made on this thread, then aborts
+//
+// Detection rides on the ALMOND_TRACK_ALLOCATIONS operator new hook
+// (amemorytracker.cpp). Without it a scope sees nothing and says so once.
+
+namespace almondnamespace::mem {
+
+    enum class NoAllocAction : std::uint8_t {
+        Count,    // silent; read allocations() before the scope ends
+        Report,   // log to std::cerr at scope exit
+        Assert    // log, then abort (also in release builds, for benchmarks)
+    };
+
+    struct heap_violation {
+        std::size_t                size = 0;
+        MemTag                     tag = MemTag::Untagged;
+        std::uint8_t               depth = 0;   // captured frames
+        std::array<void*, 16>      frames{};
+    };
+
+    namespace _detail {
+        inline constexpr std::size_t max_heap_violations = 8;
+
+        struct no_alloc_state {
+            int           depth = 0;       // nested active scopes
+            bool          capture = false; // take backtraces
+            std::uint64_t count = 0;       // allocations seen while depth > 0
+            std::uint64_t bytes = 0;
+            std::uint64_t recorded = 0;    // violations written, ring-indexed
+            std::array<heap_violation, max_heap_violations> violations{};
+        };
+
+        inline thread_local no_alloc_state t_no_alloc{};
+
+        // set by amemorytracker.cpp when the hook is compiled in
+        inline std::atomic<bool> g_heap_hook_installed{ false };
+
+        // amemorytracker.cpp; must not allocate through operator new
+        std::size_t capture_backtrace(void** frames, std::size_t max, std::size_t skip) noexcept;
+        void        write_backtrace(std::ostream& os, void* const* frames, std::size_t n);
+
+        /// called by the heap hook for every successful allocation
+        inline void note_heap_allocation(std::size_t n, MemTag tag) noexcept {
+            auto& s = t_no_alloc;
+            if (s.depth == 0) return;
+            ++s.count;
+            s.bytes += n;
+
+            auto& v = s.violations[s.recorded++ % max_heap_violations];
+            v.size = n;
+            v.tag = tag;
+            v.depth = 0;
+            if (s.capture) {
+                const int depth = s.depth;
+                s.depth = 0;   // an allocating unwinder must not recurse into us
+                v.depth = static_cast<std::uint8_t>(capture_backtrace(v.frames.data(), v.frames.size(), 3));
+                s.depth = depth;
+            }
+        }
+    }
+
+    /// counts (and optionally backtraces) heap allocations on this thread
+    /// while alive; nests, each scope reporting only its own
+    class NoAllocScope {
+    public:
+        explicit NoAllocScope(std::string_view name,
+            NoAllocAction action = NoAllocAction::Report,
+            bool captureBacktraces = false) noexcept
+            : name_{ name }, action_{ action } {
+            auto& s = _detail::t_no_alloc;
+            startCount_ = s.count;
+            startBytes_ = s.bytes;
+            startRecorded_ = s.recorded;
+            prevCapture_ = s.capture;
+            s.capture = s.capture || captureBacktraces;
+            ++s.depth;
+        }
+
+        ~NoAllocScope() {
+            auto& s = _detail::t_no_alloc;
+            --s.depth;
+            s.capture = prevCapture_;
+            if (action_ == NoAllocAction::Count) return;
+
+            // reporting allocates; keep enclosing scopes from charging for it
+            const int depth = s.depth;
+            s.depth = 0;
+            if (!_detail::g_heap_hook_installed.load(std::memory_order_relaxed))
+                warn_no_hook();
+            else if (allocations() != 0)
+                report(std::cerr);
+            s.depth = depth;
+
+            if (action_ == NoAllocAction::Assert && allocations() != 0)
+                std::abort();
+        }
+
+        NoAllocScope(const NoAllocScope&) = delete;
+        NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+        std::uint64_t allocations() const noexcept { return _detail::t_no_alloc.count - startCount_; }
+        std::uint64_t bytes()       const noexcept { return _detail::t_no_alloc.bytes - startBytes_; }
+
+        void report(std::ostream& os) const {
+            const auto& s = _detail::t_no_alloc;
+            os << "[NoAlloc] '" << name_ << "': " << allocations() << " heap allocation(s), "
+               << bytes() << " bytes\n";
+
+            const auto recorded = s.recorded - startRecorded_;
+            const auto shown = recorded < _detail::max_heap_violations ? recorded : _detail::max_heap_violations;
+            for (std::uint64_t i = s.recorded - shown; i < s.recorded; ++i) {
+                const auto& v = s.violations[i % _detail::max_heap_violations];
+                os << "  #" << (i - startRecorded_) << ' ' << v.size << " bytes [" << to_string(v.tag) << "]\n";
+                if (v.depth) _detail::write_backtrace(os, v.frames.data(), v.depth);
+            }
+            if (recorded > shown)
+                os << "  (" << (recorded - shown) << " earlier allocation(s) not kept)\n";
+        }
+
+    private:
+        static void warn_no_hook() {
+            static std::atomic<bool> warned{ false };
+            if (!warned.exchange(true))
+                std::cerr << "[NoAlloc] ALMOND_TRACK_ALLOCATIONS is off; NoAllocScope cannot see heap allocations\n";
+        }
+
+        std::string_view name_;
+        NoAllocAction    action_;
+        std::uint64_t    startCount_ = 0;
+        std::uint64_t    startBytes_ = 0;
+        std::uint64_t    startRecorded_ = 0;
+        bool             prevCapture_ = false;
+    };
 
-void* operator new (std::size_t) = delete;
-void* operator new[](std::size_t) = delete;
-void  operator delete (void*, std::size_t) = delete;
-void  operator delete[](void*, std::size_t) = delete;
+} // namespace almondnamespace::mem
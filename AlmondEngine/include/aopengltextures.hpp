@@ -196,6 +196,7 @@ namespace almondnamespace::opengltextures
 
         glBindTexture(GL_TEXTURE_2D, gpu.textureHandle);
 
+        bool fullUpload = false;
         if (gpu.width != atlas.width || gpu.height != atlas.height) {
 #ifdef GL_ARB_texture_storage
             glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, atlas.width, atlas.height);
@@ -206,12 +207,29 @@ namespace almondnamespace::opengltextures
 #endif
             gpu.width = atlas.width;
             gpu.height = atlas.height;
+            fullUpload = true;
         }
 
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-            atlas.width, atlas.height,
-            GL_RGBA, GL_UNSIGNED_BYTE,
-            atlas.pixel_data.data());
+        // Only the rectangles touched since our last upload go over the bus,
+        // unless we missed a batch (version gap) or the atlas asked for a full one.
+        auto dirty = atlas.consume_dirty_regions();
+        if (fullUpload || dirty.full || dirty.since_version != gpu.version) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                atlas.width, atlas.height,
+                GL_RGBA, GL_UNSIGNED_BYTE,
+                atlas.pixel_data.data());
+        }
+        else {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(atlas.width));
+            for (const auto& r : dirty.rects) {
+                const u8* src = atlas.pixel_data.data()
+                    + (static_cast<size_t>(r.y) * atlas.width + r.x) * 4;
+                glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y,
+                    r.width, r.height,
+                    GL_RGBA, GL_UNSIGNED_BYTE, src);
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        }
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
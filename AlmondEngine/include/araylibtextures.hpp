@@ -158,6 +158,20 @@ namespace almondnamespace::raylibtextures
             return;
         }
 
+        auto dirty = atlas.consume_dirty_regions();
+        if (gpu.texture.id != 0 && gpu.width == atlas.width && gpu.height == atlas.height
+            && !dirty.full && dirty.since_version == gpu.version) {
+            std::vector<u8> scratch;
+            for (const auto& r : dirty.rects) {
+                atlas.copy_region(r, scratch);
+                UpdateTextureRec(gpu.texture,
+                    Rectangle{ float(r.x), float(r.y), float(r.width), float(r.height) },
+                    scratch.data());
+            }
+            gpu.version = atlas.version;
+            return;
+        }
+
         if (gpu.texture.id != 0) {
             UnloadTexture(gpu.texture);
         }
@@ -19,170 +19,528 @@
  *   No obligation to disclose modifications.                 *
  *   See LICENSE file for full terms.                         *
  **************************************************************/
+ // asaveloadsystem.hpp
+#pragma once
+
+#include "aplatform.hpp"   // must always come first
 #include "aeventsystem.hpp"
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
-#include <map>
-#include <iostream>
-#include <fstream>
-#include <sstream>
 
 namespace almondnamespace {
 
+    namespace events {
+        // posted by AsyncSaver from its thread; delivered by pump() on yours
+        struct SaveCompletedEvent { std::uint64_t ticket{ 0 }; bool ok{ false }; };
+
+        // nobody may be pumping when a save lands: never block the saver
+        template<>
+        inline constexpr OverflowPolicy channel_overflow_policy<SaveCompletedEvent> = OverflowPolicy::DropOldest;
+    }
+
+    // ─── Save file layout (all integers little‑endian) ───────────────────
+    //   header  : "ALSV" u16 version u16 flags u32 reserved      (raw)
+    //   body    : zlib stream when flags & Compressed, else raw bytes
+    //     record: u8 type f32 x f32 y u32 key u32 text u32 pairs
+    //             { u32 len, bytes key; u32 len, bytes value } × pairs
+    //     end   : u8 0xFF u64 record count
+    // Writer and reader move data through fixed kChunk buffers, so memory is
+    // constant in the save size and load is a single linear pass.
     class SaveSystem {
     public:
-        static void SaveGame(const std::string& filename, const std::vector<almondnamespace::events::Event>& events) {  
-           std::ofstream ofs(filename, std::ios::binary);  
-           if (!ofs) {  
-               std::cerr << "Error opening file for saving!" << std::endl;  
-               return;  
-           }  
-
-           std::string data;  
-           for (const auto& event : events) {  
-               data += event_type_to_string(event.type) + ":";  
-               for (const auto& pair : event.data) {  
-                   data += pair.first + "=" + pair.second + ";";  
-               }  
-               data += "x=" + std::to_string(event.x) + ";";  
-               data += "y=" + std::to_string(event.y) + ";";  
-               data += "key=" + std::to_string(event.key) + ";";  
-
-               // Fix for the error: Convert char32_t to UTF-8 string before appending  
-               std::string utf8Text;  
-               if (event.text != 0) {  
-                   char buffer[5] = { 0 };  
-                   if (event.text <= 0x7F) {  
-                       buffer[0] = static_cast<char>(event.text);  
-                   } else if (event.text <= 0x7FF) {  
-                       buffer[0] = static_cast<char>(0xC0 | ((event.text >> 6) & 0x1F));  
-                       buffer[1] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                   } else if (event.text <= 0xFFFF) {  
-                       buffer[0] = static_cast<char>(0xE0 | ((event.text >> 12) & 0x0F));  
-                       buffer[1] = static_cast<char>(0x80 | ((event.text >> 6) & 0x3F));  
-                       buffer[2] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                   } else {  
-                       buffer[0] = static_cast<char>(0xF0 | ((event.text >> 18) & 0x07));  
-                       buffer[1] = static_cast<char>(0x80 | ((event.text >> 12) & 0x3F));  
-                       buffer[2] = static_cast<char>(0x80 | ((event.text >> 6) & 0x3F));  
-                       buffer[3] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                   }  
-                   utf8Text = std::string(buffer);  
-               }  
-               data += "text=" + utf8Text + ";";  
-               data += "\n";  
-           }  
-
-           std::string compressedData = CompressData(data);  
-           ofs.write(compressedData.c_str(), compressedData.size());  
-           ofs.close();  
-        }
+        static constexpr std::array<char, 4> kMagic{ 'A', 'L', 'S', 'V' };
+        static constexpr std::uint16_t kVersion = 1;
+        static constexpr std::uint16_t kFlagCompressed = 0x1;
+        static constexpr std::size_t   kChunk = 64 * 1024;
+        static constexpr std::uint8_t  kEndMarker = 0xFF;
+        static constexpr std::uint32_t kMaxString = 16u * 1024 * 1024;   // per key/value; longer reads as corrupt
+
+        // ── streaming writer: write() as many events as needed, then finish()
+        class Writer {
+        public:
+            explicit Writer(const std::string& filename, bool compress = true)
+                : ofs_(filename, std::ios::binary), compress_(compress)
+            {
+                if (!ofs_) {
+                    std::cerr << "[SaveSystem] Error opening '" << filename << "' for saving\n";
+                    return;
+                }
+                ofs_.write(kMagic.data(), kMagic.size());
+                put_raw_u16(kVersion);
+                put_raw_u16(compress_ ? kFlagCompressed : 0);
+                put_raw_u32(0);
+
+                if (compress_ && deflateInit(&zs_, Z_DEFAULT_COMPRESSION) != Z_OK) {
+                    std::cerr << "[SaveSystem] deflateInit failed\n";
+                    ofs_.setstate(std::ios::failbit);
+                    return;
+                }
+                zsOpen_ = compress_;
+                in_.reserve(kChunk);
+            }
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            ~Writer() {
+                if (!finished_) finish();
+            }
+
+            [[nodiscard]] bool ok() const noexcept { return static_cast<bool>(ofs_); }
+
+            void write(const events::Event& e) {
+                put_u8(static_cast<std::uint8_t>(e.type));
+                put_f32(e.x);
+                put_f32(e.y);
+                put_u32(e.key);
+                put_u32(static_cast<std::uint32_t>(e.text));
+                put_u32(static_cast<std::uint32_t>(e.data.size()));
+                for (const auto& [k, v] : e.data) {
+                    put_string(k);
+                    put_string(v);
+                }
+                ++count_;
+            }
+
+            bool finish() {
+                if (finished_) return ok();
+                finished_ = true;
+                put_u8(kEndMarker);
+                put_u64(count_);
+                flush(true);
+                if (zsOpen_) deflateEnd(&zs_);
+                zsOpen_ = false;
+                ofs_.close();
+                return !ofs_.fail();
+            }
+
+        private:
+            void put_u8(std::uint8_t v) {
+                in_.push_back(v);
+                if (in_.size() >= kChunk) flush(false);
+            }
+            void put_u16(std::uint16_t v) { put_u8(std::uint8_t(v)); put_u8(std::uint8_t(v >> 8)); }
+            void put_u32(std::uint32_t v) { put_u16(std::uint16_t(v)); put_u16(std::uint16_t(v >> 16)); }
+            void put_u64(std::uint64_t v) { put_u32(std::uint32_t(v)); put_u32(std::uint32_t(v >> 32)); }
+            void put_f32(float f) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &f, sizeof bits);
+                put_u32(bits);
+            }
+            void put_string(const std::string& str) {
+                if (str.size() > kMaxString) {   // Reader would reject it: fail the save instead
+                    std::cerr << "[SaveSystem] String of " << str.size() << " bytes exceeds kMaxString\n";
+                    ofs_.setstate(std::ios::failbit);
+                    return;
+                }
+                put_u32(static_cast<std::uint32_t>(str.size()));
+                for (char c : str) put_u8(static_cast<std::uint8_t>(c));
+            }
+
+            void put_raw_u16(std::uint16_t v) {
+                const char b[2] = { char(v & 0xFF), char(v >> 8) };
+                ofs_.write(b, 2);
+            }
+            void put_raw_u32(std::uint32_t v) {
+                put_raw_u16(std::uint16_t(v));
+                put_raw_u16(std::uint16_t(v >> 16));
+            }
+
+            // push the staged bytes through deflate (or straight out) in kChunk pieces
+            void flush(bool last) {
+                if (!ofs_) { in_.clear(); return; }
+                if (!compress_) {
+                    ofs_.write(reinterpret_cast<const char*>(in_.data()), static_cast<std::streamsize>(in_.size()));
+                    in_.clear();
+                    return;
+                }
+
+                zs_.next_in = in_.data();
+                zs_.avail_in = static_cast<uInt>(in_.size());
+                const int mode = last ? Z_FINISH : Z_NO_FLUSH;
+                int rc;
+                do {
+                    zs_.next_out = out_.data();
+                    zs_.avail_out = static_cast<uInt>(out_.size());
+                    rc = deflate(&zs_, mode);
+                    if (rc == Z_STREAM_ERROR) {
+                        ofs_.setstate(std::ios::failbit);
+                        break;
+                    }
+                    ofs_.write(reinterpret_cast<const char*>(out_.data()),
+                        static_cast<std::streamsize>(out_.size() - zs_.avail_out));
+                } while (zs_.avail_out == 0 || (last && rc != Z_STREAM_END));
+                in_.clear();
+            }
+
+            std::ofstream                 ofs_;
+            bool                          compress_;
+            bool                          zsOpen_{ false };
+            bool                          finished_{ false };
+            z_stream                      zs_{};
+            std::vector<Bytef>            in_;
+            std::array<Bytef, kChunk>     out_{};
+            std::uint64_t                 count_{ 0 };
+        };
+
+        // ── streaming reader: next() until it returns false
+        class Reader {
+        public:
+            explicit Reader(const std::string& filename)
+                : ifs_(filename, std::ios::binary)
+            {
+                if (!ifs_) {
+                    error_ = "cannot open file";
+                    return;
+                }
+                std::array<char, 4> magic{};
+                unsigned char hdr[8]{};
+                ifs_.read(magic.data(), magic.size());
+                ifs_.read(reinterpret_cast<char*>(hdr), sizeof hdr);
+                if (!ifs_ || magic != kMagic) {
+                    error_ = "not an Almond save file";
+                    return;
+                }
+                version_ = static_cast<std::uint16_t>(hdr[0] | (hdr[1] << 8));
+                const auto flags = static_cast<std::uint16_t>(hdr[2] | (hdr[3] << 8));
+                if (version_ == 0 || version_ > kVersion) {
+                    error_ = "unsupported save version " + std::to_string(version_);
+                    return;
+                }
+                compressed_ = (flags & kFlagCompressed) != 0;
+                if (compressed_) {
+                    if (inflateInit(&zs_) != Z_OK) {
+                        error_ = "inflateInit failed";
+                        return;
+                    }
+                    zsOpen_ = true;
+                }
+                good_ = true;
+            }
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            ~Reader() {
+                if (zsOpen_) inflateEnd(&zs_);
+            }
+
+            [[nodiscard]] bool ok() const noexcept { return good_; }
+            [[nodiscard]] const std::string& error() const noexcept { return error_; }
+            [[nodiscard]] std::uint16_t version() const noexcept { return version_; }
+
+            // false at the end marker or on error (see error())
+            bool next(events::Event& e) {
+                if (!good_ || done_) return false;
+
+                std::uint8_t type = 0;
+                if (!get_u8(type)) return fail("truncated save");
+                if (type == kEndMarker) {
+                    std::uint64_t expected = 0;
+                    if (!get_u64(expected)) return fail("truncated save");
+                    if (expected != count_) return fail("record count mismatch");
+                    done_ = true;
+                    return false;
+                }
+
+                e = events::Event{};
+                e.type = static_cast<events::EventType>(type);
+                std::uint32_t text = 0, pairs = 0;
+                if (!get_f32(e.x) || !get_f32(e.y) || !get_u32(e.key) || !get_u32(text) || !get_u32(pairs))
+                    return fail("truncated save");
+                e.text = static_cast<char32_t>(text);
+
+                std::string k, v;
+                for (std::uint32_t i = 0; i < pairs; ++i) {
+                    if (!get_string(k) || !get_string(v)) return good_ ? fail("truncated save") : false;
+                    e.data.emplace(std::move(k), std::move(v));
+                }
+                ++count_;
+                return true;
+            }
+
+        private:
+            bool fail(const char* why) {
+                error_ = why;
+                good_ = false;
+                return false;
+            }
 
-        static void LoadGame(const std::string& filename, std::vector<almondnamespace::events::Event>& events) {
-            std::ifstream ifs(filename, std::ios::binary);
-            if (!ifs) {
-                std::cerr << "Error opening file for loading!" << std::endl;
-                return;
-            }
-
-            std::string compressedData((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-            std::string data = DecompressData(compressedData);
-
-            size_t pos = 0;
-            while ((pos = data.find('\n')) != std::string::npos) {
-                std::string line = data.substr(0, pos);
-                events::Event event;
-
-                size_t typeEnd = line.find(':');
-                if (typeEnd == std::string::npos) {
-                    data.erase(0, pos + 1);
-                    continue;
-                }
-
-                event.type = almondnamespace::events::event_type_from(line.substr(0, typeEnd));
-                std::string details = line.substr(typeEnd + 1);
-
-                size_t semicolonPos;
-                while ((semicolonPos = details.find(';')) != std::string::npos) {
-                    std::string keyValue = details.substr(0, semicolonPos);
-                    size_t equalPos = keyValue.find('=');
-                    if (equalPos != std::string::npos) {
-                        std::string key = keyValue.substr(0, equalPos);
-                        std::string value = keyValue.substr(equalPos + 1);
-
-                        if (key == "x") {
-                            event.x = std::stof(value);
-                        }
-                        else if (key == "y") {
-                            event.y = std::stof(value);
-                        }
-                        else if (key == "key") {
-                            event.key = std::stoi(value);
-                        }
-                        else if (key == "text") {
-                            // Replace the problematic line with the following code to fix the error:  
-                            // Fix for the error: Use a temporary buffer to handle char32_t to char conversion  
-                            char buffer[5] = { 0 };  
-                            // Replace the problematic line with the following code to fix the error:  
-                            //std::memset(event.text, 0, sizeof(event.text));  
-                            if (event.text <= 0x7F) {  
-                                buffer[0] = static_cast<char>(event.text);  
-                            } else if (event.text <= 0x7FF) {  
-                                buffer[0] = static_cast<char>(0xC0 | ((event.text >> 6) & 0x1F));  
-                                buffer[1] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                            } else if (event.text <= 0xFFFF) {  
-                                buffer[0] = static_cast<char>(0xE0 | ((event.text >> 12) & 0x0F));  
-                                buffer[1] = static_cast<char>(0x80 | ((event.text >> 6) & 0x3F));  
-                                buffer[2] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                            } else {  
-                                buffer[0] = static_cast<char>(0xF0 | ((event.text >> 18) & 0x07));  
-                                buffer[1] = static_cast<char>(0x80 | ((event.text >> 12) & 0x3F));  
-                                buffer[2] = static_cast<char>(0x80 | ((event.text >> 6) & 0x3F));  
-                                buffer[3] = static_cast<char>(0x80 | (event.text & 0x3F));  
-                            }  
-                            std::memset(reinterpret_cast<void*>(&event.text), 0, sizeof(event.text));
-                            std::strncpy(reinterpret_cast<char*>(event.text), buffer, sizeof(event.text) - 1);
-
-                            //strncpy_s(event.text, value.c_str(), sizeof(event.text) - 1);
-                           // event.text[sizeof(event.text) - 1] = '\0';
-                        }
-                        else {
-                            event.data[key] = value;
-                        }
+            // refill out_ with the next decoded (or raw) kChunk
+            bool refill() {
+                pos_ = len_ = 0;
+                if (!compressed_) {
+                    ifs_.read(reinterpret_cast<char*>(out_.data()), out_.size());
+                    len_ = static_cast<std::size_t>(ifs_.gcount());
+                    return len_ > 0;
+                }
+                if (streamEnd_) return false;
+
+                zs_.next_out = out_.data();
+                zs_.avail_out = static_cast<uInt>(out_.size());
+                while (zs_.avail_out == out_.size()) {
+                    if (zs_.avail_in == 0) {
+                        ifs_.read(reinterpret_cast<char*>(in_.data()), in_.size());
+                        zs_.next_in = in_.data();
+                        zs_.avail_in = static_cast<uInt>(ifs_.gcount());
+                        if (zs_.avail_in == 0) break;
                     }
-                    details.erase(0, semicolonPos + 1);
+                    const int rc = inflate(&zs_, Z_NO_FLUSH);
+                    if (rc == Z_STREAM_END) { streamEnd_ = true; break; }
+                    if (rc != Z_OK) return false;
+                }
+                len_ = out_.size() - zs_.avail_out;
+                return len_ > 0;
+            }
+
+            bool get_bytes(void* dst, std::size_t n) {
+                auto* d = static_cast<std::uint8_t*>(dst);
+                while (n > 0) {
+                    if (pos_ == len_ && !refill()) return false;
+                    const std::size_t take = std::min(n, len_ - pos_);
+                    std::memcpy(d, out_.data() + pos_, take);
+                    pos_ += take; d += take; n -= take;
+                }
+                return true;
+            }
+
+            bool get_u8(std::uint8_t& v) { return get_bytes(&v, 1); }
+            bool get_u32(std::uint32_t& v) {
+                std::uint8_t b[4];
+                if (!get_bytes(b, 4)) return false;
+                v = std::uint32_t(b[0]) | (std::uint32_t(b[1]) << 8) | (std::uint32_t(b[2]) << 16) | (std::uint32_t(b[3]) << 24);
+                return true;
+            }
+            bool get_u64(std::uint64_t& v) {
+                std::uint32_t lo, hi;
+                if (!get_u32(lo) || !get_u32(hi)) return false;
+                v = std::uint64_t(lo) | (std::uint64_t(hi) << 32);
+                return true;
+            }
+            bool get_f32(float& f) {
+                std::uint32_t bits;
+                if (!get_u32(bits)) return false;
+                std::memcpy(&f, &bits, sizeof f);
+                return true;
+            }
+            // the length comes off disk: cap it, and grow only as bytes
+            // actually arrive so a truncated file can't demand 4 GiB up front
+            bool get_string(std::string& str) {
+                std::uint32_t n;
+                if (!get_u32(n)) return false;
+                if (n > kMaxString) return fail("corrupt save");
+                str.clear();
+                while (n > 0) {
+                    const std::size_t take = std::min<std::size_t>(n, kChunk);
+                    const std::size_t at = str.size();
+                    str.resize(at + take);
+                    if (!get_bytes(str.data() + at, take)) return false;
+                    n -= static_cast<std::uint32_t>(take);
                 }
+                return true;
+            }
+
+            std::ifstream              ifs_;
+            std::string                error_;
+            std::uint16_t              version_{ 0 };
+            bool                       compressed_{ false };
+            bool                       zsOpen_{ false };
+            bool                       streamEnd_{ false };
+            bool                       good_{ false };
+            bool                       done_{ false };
+            z_stream                   zs_{};
+            std::array<Bytef, kChunk>  in_{};
+            std::array<Bytef, kChunk>  out_{};
+            std::size_t                pos_{ 0 }, len_{ 0 };
+            std::uint64_t              count_{ 0 };
+        };
 
-                events.push_back(event);
-                data.erase(0, pos + 1);
+        static bool SaveGame(const std::string& filename, const std::vector<almondnamespace::events::Event>& events) {
+            auto w = std::make_unique<Writer>(filename);
+            if (!w->ok()) return false;
+            for (const auto& event : events) w->write(event);
+            return w->finish();
+        }
+
+        // write to "<filename>.tmp", then rename over the target: a crash
+        // mid‑save leaves the previous save intact
+        static bool SaveGameAtomic(const std::string& filename, const std::vector<almondnamespace::events::Event>& events) {
+            const std::string tmp = filename + ".tmp";
+            std::error_code ec;
+            if (!SaveGame(tmp, events)) {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+            std::filesystem::rename(tmp, filename, ec);
+            if (ec) {
+                std::cerr << "[SaveSystem] Failed to replace '" << filename << "': " << ec.message() << "\n";
+                std::filesystem::remove(tmp, ec);
+                return false;
             }
+            return true;
+        }
+
+        // returns at once; see AsyncSaver
+        static std::future<bool> SaveGameAsync(const std::string& filename, std::vector<almondnamespace::events::Event> events, std::uint64_t* ticket = nullptr);
+        // shared form: no copy, the caller may keep reading the same snapshot
+        static std::future<bool> SaveGameAsync(const std::string& filename, std::shared_ptr<const std::vector<almondnamespace::events::Event>> events, std::uint64_t* ticket = nullptr);
 
-            ifs.close();
+        // visitor form: events are handed over one at a time, nothing is buffered
+        static bool LoadGame(const std::string& filename, const std::function<void(events::Event&&)>& onEvent) {
+            auto r = std::make_unique<Reader>(filename);
+            events::Event event;
+            while (r->next(event)) onEvent(std::move(event));
+            if (!r->ok()) {
+                std::cerr << "[SaveSystem] Failed to load '" << filename << "': " << r->error() << "\n";
+                return false;
+            }
+            return true;
         }
 
-    private:
-        static std::string CompressData(const std::string& data) {
-            uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
-            std::vector<Bytef> compressedData(compressedSize);
-            if (compress(compressedData.data(), &compressedSize, reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size())) != Z_OK) {
-                return data;
-            }
-            compressedData.resize(compressedSize);
-            return std::string(reinterpret_cast<char*>(compressedData.data()), compressedSize);
+        static bool LoadGame(const std::string& filename, std::vector<almondnamespace::events::Event>& events) {
+            return LoadGame(filename, [&](events::Event&& e) { events.push_back(std::move(e)); });
+        }
+    };
+
+    // ─── AsyncSaver ──────────────────────────────────────────────────────
+    // One background thread that serializes, compresses and atomically
+    // writes saves, so the game thread only pays for handing over the
+    // snapshot: move a vector in, or pass a shared_ptr<const vector> to
+    // share one immutable capture without copying it. At most one pending
+    // save per file is kept: a newer snapshot for a file still waiting in
+    // the queue replaces the older one, and both callers' futures receive
+    // the newer result. Completion is reported through the future and, when
+    // the game pumps events, one events::SaveCompletedEvent per ticket,
+    // superseded ones included.
+    // The completion channel is created before the saver, so it outlives
+    // the saver thread that the destructor drains and joins at exit.
+    class AsyncSaver {
+    public:
+        static AsyncSaver& instance() {
+            static AsyncSaver saver;
+            return saver;
+        }
+
+        AsyncSaver(const AsyncSaver&) = delete;
+        AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+        ~AsyncSaver() {
+            {
+                std::lock_guard lock(mtx_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            if (thread_.joinable()) thread_.join();
+        }
+
+        std::future<bool> save(std::string filename, std::vector<events::Event> snapshot, std::uint64_t* ticketOut = nullptr) {
+            return save(std::move(filename),
+                std::make_shared<const std::vector<events::Event>>(std::move(snapshot)), ticketOut);
+        }
+
+        std::future<bool> save(std::string filename, std::shared_ptr<const std::vector<events::Event>> snapshot, std::uint64_t* ticketOut = nullptr) {
+            std::promise<bool> promise;
+            auto future = promise.get_future();
+            const std::uint64_t ticket = nextTicket_.fetch_add(1, std::memory_order_relaxed);
+            if (ticketOut) *ticketOut = ticket;
+
+            {
+                std::lock_guard lock(mtx_);
+                auto it = std::find_if(queue_.begin(), queue_.end(),
+                    [&](const Job& j) { return j.filename == filename; });
+                if (it != queue_.end()) {
+                    it->snapshot = std::move(snapshot);
+                    it->tickets.push_back(ticket);
+                    it->promises.push_back(std::move(promise));
+                }
+                else {
+                    Job job{ { ticket }, std::move(filename), std::move(snapshot), {} };
+                    job.promises.push_back(std::move(promise));
+                    queue_.push_back(std::move(job));
+                }
+                if (!thread_.joinable()) thread_ = std::thread([this] { run(); });
+            }
+            cv_.notify_one();
+            return future;
+        }
+
+        // block until every queued save has been written
+        void wait_idle() {
+            std::unique_lock lock(mtx_);
+            idle_.wait(lock, [&] { return queue_.empty() && !busy_; });
         }
 
-        static std::string DecompressData(const std::string& compressedData) {
-            uLongf decompressedSize = static_cast<uLong>(compressedData.size()) * 4;
-            std::vector<Bytef> decompressedData(decompressedSize);
-            while (uncompress(decompressedData.data(), &decompressedSize, reinterpret_cast<const Bytef*>(compressedData.data()), static_cast<uLong>(compressedData.size())) == Z_BUF_ERROR) {
-                decompressedSize *= 2;
-                decompressedData.resize(decompressedSize);
+    private:
+        // touch the channel first: function-local statics die in reverse
+        // order, so it is destroyed only after ~AsyncSaver has joined
+        AsyncSaver() { (void)events::channel<events::SaveCompletedEvent>(); }
+
+        struct Job {
+            std::vector<std::uint64_t>                        tickets;   // every caller folded into this job
+            std::string                                       filename;
+            std::shared_ptr<const std::vector<events::Event>> snapshot;
+            std::vector<std::promise<bool>>                   promises;
+        };
+
+        void run() {
+            for (;;) {
+                Job job;
+                {
+                    std::unique_lock lock(mtx_);
+                    cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+                    if (queue_.empty()) return;     // stop_ and drained
+                    job = std::move(queue_.front());
+                    queue_.pop_front();
+                    busy_ = true;
+                }
+
+                const bool ok = job.snapshot && SaveSystem::SaveGameAtomic(job.filename, *job.snapshot);
+                job.snapshot.reset();
+                for (auto& p : job.promises) p.set_value(ok);
+                for (auto t : job.tickets) events::post(events::SaveCompletedEvent{ t, ok });
+
+                {
+                    std::lock_guard lock(mtx_);
+                    busy_ = false;
+                }
+                idle_.notify_all();
             }
-            return std::string(reinterpret_cast<char*>(decompressedData.data()), decompressedSize);
         }
+
+        std::mutex                 mtx_;
+        std::condition_variable    cv_;
+        std::condition_variable    idle_;
+        std::deque<Job>            queue_;
+        std::thread                thread_;
+        bool                       stop_{ false };
+        bool                       busy_{ false };
+        std::atomic<std::uint64_t> nextTicket_{ 1 };
     };
 
+    inline std::future<bool> SaveSystem::SaveGameAsync(const std::string& filename, std::vector<almondnamespace::events::Event> events, std::uint64_t* ticket) {
+        return AsyncSaver::instance().save(filename, std::move(events), ticket);
+    }
+
+    inline std::future<bool> SaveSystem::SaveGameAsync(const std::string& filename, std::shared_ptr<const std::vector<almondnamespace::events::Event>> events, std::uint64_t* ticket) {
+        return AsyncSaver::instance().save(filename, std::move(events), ticket);
+    }
+
 }  // namespace almond
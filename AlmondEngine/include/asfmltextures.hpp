@@ -139,10 +139,22 @@ namespace almondnamespace::sfmlcontext
             return;
         }
 
-        sf::Image image({ atlas.width, atlas.height }, atlas.pixel_data.data());
+        auto dirty = atlas.consume_dirty_regions();
+        const bool sameSize = gpu.texture.getSize().x == atlas.width && gpu.texture.getSize().y == atlas.height;
+
+        if (sameSize && !dirty.full && dirty.since_version == gpu.version) {
+            std::vector<u8> scratch;
+            for (const auto& r : dirty.rects) {
+                atlas.copy_region(r, scratch);
+                gpu.texture.update(scratch.data(), { r.width, r.height }, { r.x, r.y });
+            }
+        }
+        else {
+            sf::Image image({ atlas.width, atlas.height }, atlas.pixel_data.data());
 
-        if (!gpu.texture.loadFromImage(image)) {
-            throw std::runtime_error("[SFML] Failed to load GPU texture from pixel_data for atlas: " + atlas.name);
+            if (!gpu.texture.loadFromImage(image)) {
+                throw std::runtime_error("[SFML] Failed to load GPU texture from pixel_data for atlas: " + atlas.name);
+            }
         }
 
         gpu.width = atlas.width;
@@ -164,8 +164,7 @@ namespace almondnamespace::spritepool
             Task task = spritepool_allocation_coroutine(this);
             auto node = std::make_unique<Node>(std::move(task));
             node->Label = "SpritePoolAllocate";
-            g_taskGraph->AddNode(std::move(node));
-            g_taskGraph->Execute();
+            g_taskGraph->Submit(std::move(node));
         }
 
         SpriteHandle await_resume() noexcept {
@@ -26,11 +26,15 @@
 #include "aenginesystems.hpp" // Reuse almondnamespace::Task
 
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <coroutine>
 #include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -40,17 +44,41 @@ namespace almondnamespace
 {
     namespace taskgraph 
     {
+        class TaskGraph;
+
+        // A node runs one of (in priority order):
+        //   Subgraph — a nested TaskGraph, finished when its last node is
+        //   Work     — re‑runnable body, executed on every Execute()
+        //   Task_    — coroutine, resumed once (one‑shot, legacy path)
         struct Node {
             Task Task_;
+            std::function<void()> Work;
+            TaskGraph* Subgraph = nullptr;
+
             std::atomic<int> PrereqCount{ 0 };
+            int InitialPrereqs = 0;
             std::vector<Node*> Dependents;
             std::string Label;
 
+            // filled in by the graph
+            TaskGraph* Owner = nullptr;
+            std::atomic<std::int64_t> StartNs{ 0 };
+            std::atomic<std::int64_t> LastNs{ 0 };   // duration of the last run
+
             explicit Node(Task&& t) : Task_(std::move(t)) {}
+            explicit Node(std::function<void()> work, std::string label = {})
+                : Task_(Task::handle_t{}), Work(std::move(work)), Label(std::move(label)) {}
+            Node(TaskGraph& sub, std::string label = {})
+                : Task_(Task::handle_t{}), Subgraph(&sub), Label(std::move(label)) {}
         };
 
         using NodePtr = std::unique_ptr<Node>;
 
+        // Frame‑graph usage: build once with AddNode/AddDependency, then call
+        // Execute()+WaitAll() (or Run()) every frame. Each Execute() resets
+        // the prerequisite counters; WaitAll() sleeps on one completion counter.
+        // A graph built with 0 workers can be nested as a Subgraph node or run
+        // on the calling thread by WaitAll().
         class TaskGraph {
         public:
             explicit TaskGraph(size_t workerCount)
@@ -68,92 +96,209 @@ namespace almondnamespace
                         t.join();
             }
 
-            void AddNode(NodePtr node) {
+            Node& AddNode(NodePtr node) {
+                node->Owner = this;
                 Nodes_.push_back(std::move(node));
+                return *Nodes_.back();
+            }
+
+            Node& AddWork(std::string label, std::function<void()> work) {
+                return AddNode(std::make_unique<Node>(std::move(work), std::move(label)));
+            }
+
+            Node& AddSubgraph(std::string label, TaskGraph& sub) {
+                return AddNode(std::make_unique<Node>(sub, std::move(label)));
             }
 
             void AddDependency(Node& a, Node& b) {
+                ++b.InitialPrereqs;
                 b.PrereqCount.fetch_add(1, std::memory_order_relaxed);
                 a.Dependents.push_back(&b);
             }
 
-            void Execute() {
-                for (auto& n : Nodes_) {
-                    if (n->PrereqCount.load(std::memory_order_acquire) == 0) {
-                        Queue_.enqueue(n.get());
-                        WorkSem_.release();
-                    }
+            // one‑shot node outside the frame graph (async jobs, coroutines);
+            // runs as soon as a worker is free and is reclaimed by a later
+            // Submit(). PrereqCount < 0 is the completion signal, stored after
+            // the worker's last touch of the node; a coroutine that suspended
+            // mid‑body and was handed off elsewhere is kept until its frame
+            // reports finished().
+            void Submit(NodePtr node) {
+                node->Owner = nullptr;
+                Node* raw = node.get();
+                {
+                    std::lock_guard lock(OneShotLock_);
+                    std::erase_if(OneShot_, [](const NodePtr& n) {
+                        return n->PrereqCount.load(std::memory_order_acquire) < 0
+                            && (!n->Task_.h || n->Task_.finished());
+                    });
+                    OneShot_.push_back(std::move(node));
                 }
+                Push(raw);
             }
 
+            // reset counters and launch every root node
+            void Execute() {
+                Launch(this, nullptr);
+            }
+
+            // sleep until the last node of the current run has finished;
+            // the caller helps with queued nodes while it waits
             void WaitAll() {
-                while (true) {
-                    bool busy = !Queue_.empty();
-                    for (auto& n : Nodes_) {
-                        if (n->PrereqCount.load(std::memory_order_acquire) >= 0) {
-                            busy = true;
-                            break;
-                        }
-                    }
-                    if (!busy)
-                        break;
-                    std::this_thread::yield();
+                for (int r; (r = Remaining_.load(std::memory_order_acquire)) != 0; ) {
+                    Node* n = nullptr;
+                    if (Executor_ && Executor_->Queue_.dequeue(n)) { Executor_->RunNode(n); continue; }
+                    Remaining_.wait(r, std::memory_order_acquire);
                 }
+                // Finish() may still be inside notify_all(); the graph must
+                // outlive that before the caller is free to destroy it
+                while (Notifying_.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+            }
+
+            void Run() {
+                Execute();
+                WaitAll();
+            }
+
+            [[nodiscard]] bool Idle() const noexcept {
+                return Remaining_.load(std::memory_order_acquire) == 0
+                    && !Notifying_.load(std::memory_order_acquire);
+            }
+
+            // duration of the last complete run, in nanoseconds
+            [[nodiscard]] std::int64_t LastRunNs() const noexcept {
+                return LastRunNs_.load(std::memory_order_relaxed);
             }
 
             void DumpDot(const std::string& path = "graph.dot") {
                 std::ofstream out(path);
-                out << "digraph G{";
-                    for (auto& n : Nodes_) {
-                        auto id = reinterpret_cast<std::uintptr_t>(n.get());
-                        out << "N" << id << "[label="" << n->Label << ""];";
-                    }
+                out << "digraph G{\n";
+                for (auto& n : Nodes_) {
+                    auto id = reinterpret_cast<std::uintptr_t>(n.get());
+                    out << "N" << id << "[label=\"" << n->Label
+                        << "\\n" << (n->LastNs.load(std::memory_order_relaxed) / 1000) << " us\"";
+                    if (n->Subgraph) out << ",shape=box3d";
+                    out << "];\n";
+                }
                 for (auto& n : Nodes_) {
                     auto s = reinterpret_cast<std::uintptr_t>(n.get());
                     for (auto* d : n->Dependents) {
                         auto t = reinterpret_cast<std::uintptr_t>(d);
-                        out << "N" << s << "->N" << t << ";";
+                        out << "N" << s << "->N" << t << ";\n";
                     }
                 }
-                out << "}";
+                out << "}\n";
+            }
+
+            // per‑node timings of the last run, next to the .dot file
+            void DumpTimings(const std::string& path = "graph_timings.csv") {
+                std::ofstream out(path);
+                out << "label,prereqs,dependents,last_ns\n";
+                for (auto& n : Nodes_) {
+                    out << n->Label << ',' << n->InitialPrereqs << ','
+                        << n->Dependents.size() << ','
+                        << n->LastNs.load(std::memory_order_relaxed) << '\n';
+                }
+                out << "total," << Nodes_.size() << ",," << LastRunNs() << '\n';
             }
 
         private:
-            void WorkerLoop() {
-                Node* n = nullptr;
-                while (Running_) {
-                    WorkSem_.acquire();
-                    if (!Running_) break;
-                    if (!Queue_.dequeue(n)) continue;
+            static std::int64_t NowNs() noexcept {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
 
-                    if (!n || !n->Task_.h) {
+            // start a run of this graph, queuing on `executor`; when `parent`
+            // is set this graph is a nested subgraph and finishing it
+            // completes that parent node
+            void Launch(TaskGraph* executor, Node* parent) {
+                assert(Idle() && "TaskGraph executed while a previous run is in flight");
+                Executor_ = executor;
+                Parent_ = parent;
+                RunStartNs_ = NowNs();
+
+                if (Nodes_.empty()) { Finish(); return; }
+
+                for (auto& n : Nodes_)
+                    n->PrereqCount.store(n->InitialPrereqs, std::memory_order_relaxed);
+                // one extra count held until Finish() has published the run
+                Remaining_.store(static_cast<int>(Nodes_.size()) + 1, std::memory_order_release);
+
+                for (auto& n : Nodes_)
+                    if (n->InitialPrereqs == 0)
+                        executor->Push(n.get());
+            }
+
+            void Push(Node* n) {
+                if (Queue_.enqueue(n)) { WorkSem_.release(); return; }
+                RunNode(n);   // queue full: run it here rather than spin
+            }
+
+            void RunNode(Node* n) {
+                if (!n) return;
+                n->StartNs.store(NowNs(), std::memory_order_relaxed);
+
+                if (n->Subgraph) {
+                    n->Subgraph->Launch(this, n);   // completes n when done
+                    return;
+                }
+                if (n->Work) {
+                    n->Work();
+                }
+                else if (n->Task_.h && !n->Task_.finished()) {
+                    n->Task_.h.resume();
+                }
 #ifndef NDEBUG
-                        std::cerr << "[TaskGraph] WARNING: null coroutine handle, skipping";
+                else if (!n->Task_.h) {
+                    std::cerr << "[TaskGraph] WARNING: node '" << n->Label << "' has nothing to run\n";
+                }
 #endif
-                            continue;
-                    }
+                Complete(n);
+            }
 
-                    n->Task_.h.resume();
-                    for (auto* d : n->Dependents) {
-                        if (d->PrereqCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-                            Queue_.enqueue(d);
-                            WorkSem_.release();
-                        }
-                    }
+            void Complete(Node* n) {
+                n->LastNs.store(NowNs() - n->StartNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+                TaskGraph* g = n->Owner;
+                if (!g) {   // one‑shot Submit()
                     n->PrereqCount.store(-1, std::memory_order_release);
+                    return;
                 }
 
-                while (Queue_.dequeue(n)) {
-                    if (!n || !n->Task_.h) continue;
-                    n->Task_.h.resume();
-                    for (auto d : n->Dependents) {
-                        if (d->PrereqCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-                            Queue_.enqueue(d);
-                            WorkSem_.release();
-                        }
-                    }
-                    n->PrereqCount.store(-1, std::memory_order_release);
+                TaskGraph* executor = g->Executor_;
+                Node* parent = g->Parent_;
+                for (auto* d : n->Dependents) {
+                    if (d->PrereqCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        executor->Push(d);
+                }
+                if (g->Remaining_.fetch_sub(1, std::memory_order_acq_rel) == 2)
+                    g->Finish(executor, parent);
+            }
+
+            void Finish() { Finish(Executor_, Parent_); }
+
+            // clearing Notifying_ is the last touch of this graph; the
+            // parent is completed afterwards through the captured pointers
+            void Finish(TaskGraph* executor, Node* parent) {
+                LastRunNs_.store(NowNs() - RunStartNs_, std::memory_order_relaxed);
+                Notifying_.store(true, std::memory_order_relaxed);
+                Remaining_.store(0, std::memory_order_release);
+                Remaining_.notify_all();
+                Notifying_.store(false, std::memory_order_release);
+                if (parent) executor->Complete(parent);
+            }
+
+            void WorkerLoop() {
+                Node* n = nullptr;
+                while (Running_) {
+                    WorkSem_.acquire();
+                    if (!Running_) break;
+                    if (!Queue_.dequeue(n)) continue;
+                    RunNode(n);
                 }
+
+                while (Queue_.dequeue(n))
+                    RunNode(n);
             }
 
             MPMCQueue<Node*> Queue_;
@@ -161,6 +306,17 @@ namespace almondnamespace
             std::atomic<bool> Running_;
             std::counting_semaphore<> WorkSem_;
             std::vector<NodePtr> Nodes_;
+
+            // current run
+            std::atomic<int> Remaining_{ 0 };
+            std::atomic<bool> Notifying_{ false };
+            TaskGraph* Executor_ = nullptr;
+            Node* Parent_ = nullptr;
+            std::int64_t RunStartNs_ = 0;
+            std::atomic<std::int64_t> LastRunNs_{ 0 };
+
+            std::mutex OneShotLock_;
+            std::vector<NodePtr> OneShot_;
         };
 
     } // namespace taskgraph
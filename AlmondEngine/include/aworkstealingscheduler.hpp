@@ -0,0 +1,435 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+ // aworkstealingscheduler.hpp
+#pragma once
+
+#include "aplatform.hpp"   // must always come first
+
+#if defined(_WIN32)
+#include "aframework.hpp"  // windows.h for SetThreadAffinityMask
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace almondnamespace::jobs
+{
+    // ─────────────────────────────────────────────────────────────────────────
+    // Counter : join point for a group of jobs (fork/join, parallel_for)
+    // ─────────────────────────────────────────────────────────────────────────
+    // A waiter may destroy the Counter as soon as done() is true, so the
+    // finishing job's last access is the inflight decrement, after notify.
+    // The first exception thrown by a job is kept and rethrown by wait().
+    struct Counter {
+        std::atomic<std::uint32_t> pending{ 0 };
+
+        [[nodiscard]] bool done() const noexcept {
+            return pending.load(std::memory_order_acquire) == 0
+                && inflight_.load(std::memory_order_acquire) == 0;
+        }
+
+        // one job finished; nothing touches *this after the final decrement
+        void complete() noexcept {
+            inflight_.fetch_add(1, std::memory_order_relaxed);
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pending.notify_all();
+            inflight_.fetch_sub(1, std::memory_order_release);
+        }
+
+        // called before complete(), so the waiter sees it once done()
+        void fail(std::exception_ptr e) noexcept {
+            if (!failed_.exchange(true, std::memory_order_acq_rel)) error_ = std::move(e);
+        }
+
+        void rethrow_if_failed() {
+            if (!failed_.load(std::memory_order_acquire)) return;
+            auto e = std::exchange(error_, nullptr);
+            failed_.store(false, std::memory_order_relaxed);
+            std::rethrow_exception(e);
+        }
+
+    private:
+        std::atomic<std::uint32_t> inflight_{ 0 };
+        std::atomic<bool>          failed_{ false };
+        std::exception_ptr         error_;
+    };
+
+    struct Job {
+        std::function<void()> fn;
+        Counter*              counter = nullptr;
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // ChaseLevDeque : owner pushes/takes at the bottom, thieves steal the top
+    // (Lê, Pop, Cohen, Zappa Nardelli — "Correct and Efficient Work‑Stealing
+    // for Weak Memory Models"). Grows by doubling; retired rings are kept
+    // until the deque dies because a thief may still be reading one.
+    // ─────────────────────────────────────────────────────────────────────────
+    template<typename T>
+        requires std::is_pointer_v<T>
+    class ChaseLevDeque {
+    public:
+        explicit ChaseLevDeque(std::size_t capacity = 256)
+            : ring_(new Ring(capacity)) {
+            assert((capacity & (capacity - 1)) == 0 && "capacity must be a power of two");
+            rings_.emplace_back(ring_.load(std::memory_order_relaxed));
+        }
+
+        ChaseLevDeque(const ChaseLevDeque&) = delete;
+        ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+        // owner only
+        void push(T item) {
+            const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t t = top_.load(std::memory_order_acquire);
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            if (b - t > static_cast<std::int64_t>(r->mask)) r = grow(r, t, b);
+            r->put(b, item);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        // owner only, LIFO
+        [[nodiscard]] T take() {
+            const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_seq_cst);
+            std::int64_t t = top_.load(std::memory_order_seq_cst);
+
+            if (t > b) {                          // empty
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            T item = r->get(b);
+            if (t == b) {                         // last one: race the thieves
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        // any thread, FIFO
+        [[nodiscard]] T steal() {
+            std::int64_t t = top_.load(std::memory_order_seq_cst);
+            const std::int64_t b = bottom_.load(std::memory_order_seq_cst);
+            if (t >= b) return nullptr;
+
+            Ring* r = ring_.load(std::memory_order_acquire);
+            T item = r->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;                   // lost the race
+            return item;
+        }
+
+        [[nodiscard]] std::size_t size_approx() const noexcept {
+            const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? static_cast<std::size_t>(b - t) : 0;
+        }
+
+    private:
+        struct Ring {
+            explicit Ring(std::size_t cap) : mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+            void put(std::int64_t i, T v) noexcept { slots[static_cast<std::size_t>(i) & mask].store(v, std::memory_order_relaxed); }
+            T    get(std::int64_t i) const noexcept { return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed); }
+
+            std::size_t                      mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        Ring* grow(Ring* old, std::int64_t t, std::int64_t b) {
+            auto* bigger = new Ring((old->mask + 1) * 2);
+            for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+            rings_.emplace_back(bigger);
+            ring_.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+        alignas(64) std::atomic<std::int64_t> top_{ 0 };
+        alignas(64) std::atomic<std::int64_t> bottom_{ 0 };
+        std::atomic<Ring*>                    ring_;
+        std::vector<std::unique_ptr<Ring>>    rings_;   // owner only
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Scheduler
+    // ─────────────────────────────────────────────────────────────────────────
+    struct SchedulerConfig {
+        unsigned    workers = 0;        // 0 → hardware_concurrency() - 1
+        bool        pinThreads = false; // worker i → core (firstCore + i) % cores
+        unsigned    firstCore = 0;
+        std::size_t spinRounds = 64;    // steal attempts before parking
+    };
+
+    class WorkStealingScheduler {
+    public:
+        WorkStealingScheduler() = default;
+        ~WorkStealingScheduler() { stop(); }
+
+        WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+        WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+        void start(const SchedulerConfig& cfg = {}) {
+            if (running_.exchange(true)) return;
+            cfg_ = cfg;
+            unsigned n = cfg.workers;
+            if (n == 0) n = std::max(1u, std::thread::hardware_concurrency()) - 1;
+            n = std::max(n, 1u);
+
+            queues_.clear();
+            for (unsigned i = 0; i < n; ++i)
+                queues_.push_back(std::make_unique<ChaseLevDeque<Job*>>());
+            for (unsigned i = 0; i < n; ++i)
+                threads_.emplace_back(&WorkStealingScheduler::worker_loop, this, i);
+        }
+
+        // drains outstanding work, then joins. running_ flips under
+        // injectLock_, so a racing submit() either lands before the drain
+        // or sees the pool stopped and runs inline.
+        void stop() {
+            {
+                std::lock_guard lock(injectLock_);
+                if (!running_.exchange(false)) return;
+            }
+            wake(true);
+            for (auto& t : threads_)
+                if (t.joinable()) t.join();
+            threads_.clear();
+
+            // anything left over runs on the caller so counters still reach zero
+            while (Job* j = pop_injected()) run(j);
+            for (auto& q : queues_)
+                while (Job* j = q->steal()) run(j);
+        }
+
+        [[nodiscard]] bool        running()      const noexcept { return running_.load(std::memory_order_acquire); }
+        [[nodiscard]] std::size_t worker_count() const noexcept { return threads_.size(); }
+
+        // index of the calling worker, or -1 on a foreign thread
+        [[nodiscard]] int worker_index() const noexcept { return tl_owner == this ? tl_index : -1; }
+
+        // queue fn; from a worker it lands on that worker's deque, otherwise
+        // on the global injection queue. Without workers it runs inline.
+        void submit(std::function<void()> fn, Counter* counter = nullptr) {
+            if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+            auto* j = new Job{ std::move(fn), counter };
+
+            if (!running()) { run(j); return; }
+
+            if (const int w = worker_index(); w >= 0) queues_[w]->push(j);
+            else {
+                std::unique_lock lock(injectLock_);
+                if (!running()) {          // lost the race with stop()
+                    lock.unlock();
+                    run(j);
+                    return;
+                }
+                injected_.push_back(j);
+            }
+            wake(false);
+        }
+
+        // block until counter hits zero, running other jobs meanwhile so a
+        // worker waiting on its own children never deadlocks the pool.
+        // Rethrows the first exception a counted job threw.
+        void wait(Counter& c) {
+            const int self = worker_index();
+            while (!c.done()) {
+                if (Job* j = find_work(self)) { run(j); continue; }
+                const std::uint32_t p = c.pending.load(std::memory_order_acquire);
+                if (p == 0 || !running()) { std::this_thread::yield(); continue; }   // p == 0: last job still leaving
+                c.pending.wait(p, std::memory_order_acquire);
+            }
+            c.rethrow_if_failed();
+        }
+
+        // fork/join: run a and b in parallel, return when both are done
+        template<typename A, typename B>
+        void invoke(A&& a, B&& b) {
+            Counter c;
+            submit(std::function<void()>(std::forward<B>(b)), &c);
+            try {
+                a();
+            }
+            catch (...) {
+                wait_quietly(c);   // b may still reference the caller's frame
+                throw;
+            }
+            wait(c);
+        }
+
+        // split [begin,end) into grain‑sized ranges and run fn(b,e) on each
+        template<typename Fn>
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn) {
+            if (end <= begin) return;
+            grain = std::max<std::size_t>(grain, 1);
+            if (!running() || end - begin <= grain) { fn(begin, end); return; }
+
+            Counter c;
+            std::size_t b = begin;
+            for (; b + grain < end; b += grain) {
+                const std::size_t e = b + grain;
+                submit([&fn, b, e] { fn(b, e); }, &c);
+            }
+            try {
+                fn(b, end);
+            }
+            catch (...) {
+                wait_quietly(c);
+                throw;
+            }
+            wait(c);
+        }
+
+    private:
+        inline static thread_local const WorkStealingScheduler* tl_owner = nullptr;
+        inline static thread_local int                          tl_index = -1;
+
+        // a throwing job neither kills the worker nor strands its counter
+        static void run(Job* j) {
+            Counter* c = j->counter;
+            try {
+                j->fn();
+            }
+            catch (...) {
+                if (c) c->fail(std::current_exception());
+                else   std::cerr << "[Jobs] Uncaught exception in detached job\n";
+            }
+            delete j;
+            if (c) c->complete();
+        }
+
+        void wait_quietly(Counter& c) noexcept {
+            try { wait(c); }
+            catch (...) {}        // the caller's own exception wins
+        }
+
+        Job* pop_injected() {
+            std::lock_guard lock(injectLock_);
+            if (injected_.empty()) return nullptr;
+            Job* j = injected_.front();
+            injected_.pop_front();
+            return j;
+        }
+
+        Job* find_work(int self) {
+            if (self >= 0)
+                if (Job* j = queues_[self]->take()) return j;
+            if (Job* j = pop_injected()) return j;
+
+            const std::size_t n = queues_.size();
+            const std::size_t start = self >= 0 ? static_cast<std::size_t>(self) + 1 : 0;
+            for (std::size_t k = 0; k < n; ++k) {
+                const std::size_t v = (start + k) % n;
+                if (static_cast<int>(v) == self) continue;
+                if (Job* j = queues_[v]->steal()) return j;
+            }
+            return nullptr;
+        }
+
+        void wake(bool all) {
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) == 0) return;
+            if (all) epoch_.notify_all();
+            else     epoch_.notify_one();
+        }
+
+        void pin(unsigned index) {
+            const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+            const unsigned core = (cfg_.firstCore + index) % cores;
+#if defined(_WIN32)
+            SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+            (void)core;
+#endif
+        }
+
+        void worker_loop(unsigned index) {
+            tl_owner = this;
+            tl_index = static_cast<int>(index);
+            if (cfg_.pinThreads) pin(index);
+
+            std::size_t idle = 0;
+            while (true) {
+                const std::uint32_t seen = epoch_.load(std::memory_order_seq_cst);
+                if (Job* j = find_work(static_cast<int>(index))) {
+                    run(j);
+                    idle = 0;
+                    continue;
+                }
+                if (!running()) break;
+                if (++idle < cfg_.spinRounds) { std::this_thread::yield(); continue; }
+
+                // park until someone submits (epoch moves) or stop()
+                sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                if (epoch_.load(std::memory_order_seq_cst) == seen) epoch_.wait(seen, std::memory_order_seq_cst);
+                sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+                idle = 0;
+            }
+
+            tl_owner = nullptr;
+            tl_index = -1;
+        }
+
+        SchedulerConfig                                  cfg_{};
+        std::vector<std::unique_ptr<ChaseLevDeque<Job*>>> queues_;
+        std::vector<std::thread>                         threads_;
+        std::mutex                                       injectLock_;
+        std::deque<Job*>                                 injected_;
+        alignas(64) std::atomic<std::uint32_t>           epoch_{ 0 };
+        alignas(64) std::atomic<std::uint32_t>           sleepers_{ 0 };
+        std::atomic<bool>                                running_{ false };
+    };
+
+    // engine‑wide instance behind jobs::parallel_for and aenginesystems.hpp
+    inline WorkStealingScheduler& scheduler() {
+        static WorkStealingScheduler s;
+        return s;
+    }
+
+    template<typename Fn>
+    inline void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn) {
+        scheduler().parallel_for(begin, end, grain, std::forward<Fn>(fn));
+    }
+
+} // namespace almondnamespace::jobs
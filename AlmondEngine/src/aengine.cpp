@@ -31,6 +31,9 @@
 #include "aplatformpump.hpp"
 #include "aversion.hpp"
 #include "aguimenu.hpp"
+#include "amemorytracker.hpp"
+#include "aallocator.hpp"
+#include "acoroutine.hpp"
 #include "aapplicationmodule.hpp"
 #include "aenduserapplication.hpp"
 #include "acommandline.hpp"
@@ -2012,6 +2015,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
         // ---- Main loop ----
         while (running) {
+            almondnamespace::mem::end_tracking_frame();
+            almondnamespace::mem::begin_frame();   // flip per-thread frame arenas
+            almondnamespace::coro::main_thread_executor().run_pending();
+
             MSG msg{};
             while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
                 if (msg.message == WM_QUIT) {
@@ -0,0 +1,151 @@
+﻿/**************************************************************
+ *   █████╗ ██╗     ███╗   ███╗   ███╗   ██╗    ██╗██████╗    *
+ *  ██╔══██╗██║     ████╗ ████║ ██╔═══██╗████╗  ██║██╔══██╗   *
+ *  ███████║██║     ██╔████╔██║ ██║   ██║██╔██╗ ██║██║  ██║   *
+ *  ██╔══██║██║     ██║╚██╔╝██║ ██║   ██║██║╚██╗██║██║  ██║   *
+ *  ██║  ██║███████╗██║ ╚═╝ ██║ ╚██████╔╝██║ ╚████║██████╔╝   *
+ *  ╚═╝  ╚═╝╚══════╝╚═╝     ╚═╝  ╚═════╝ ╚═╝  ╚═══╝╚═════╝    *
+ *                                                            *
+ *   This file is part of the Almond Project.                 *
+ *   AlmondEngine - Modular C++ Game Engine                   *
+ *                                                            *
+ *   SPDX-License-Identifier: LicenseRef-MIT-NoSell           *
+ *                                                            *
+ *   Provided "AS IS", without warranty of any kind.          *
+ *   Use permitted for non-commercial purposes only           *
+ *   without prior commercial licensing agreement.            *
+ *                                                            *
+ *   Redistribution allowed with this notice.                 *
+ *   No obligation to disclose modifications.                 *
+ *   See LICENSE file for full terms.                         *
+ **************************************************************/
+#include "pch.h"
+
+#include "amemorytracker.hpp"
+#include "anoheapguard.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ALMOND_HAS_EXECINFO 1
+#endif
+#endif
+
+// Backtraces for NoAllocScope. Capture runs inside operator new, so it must
+// not allocate through it; symbolising happens later, at scope exit.
+namespace almondnamespace::mem::_detail
+{
+    std::size_t capture_backtrace(void** frames, std::size_t max, std::size_t skip) noexcept {
+#if defined(_WIN32)
+        return RtlCaptureStackBackTrace(static_cast<DWORD>(skip), static_cast<DWORD>(max), frames, nullptr);
+#elif defined(ALMOND_HAS_EXECINFO)
+        void* raw[64];
+        const int got = ::backtrace(raw, static_cast<int>(std::min<std::size_t>(max + skip, 64)));
+        std::size_t n = 0;
+        for (int i = static_cast<int>(skip); i < got && n < max; ++i) frames[n++] = raw[i];
+        return n;
+#else
+        (void)frames; (void)max; (void)skip;
+        return 0;
+#endif
+    }
+
+    void write_backtrace(std::ostream& os, void* const* frames, std::size_t n) {
+#if defined(ALMOND_HAS_EXECINFO)
+        if (char** names = ::backtrace_symbols(frames, static_cast<int>(n))) {
+            for (std::size_t i = 0; i < n; ++i) os << "      " << names[i] << '\n';
+            std::free(names);
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < n; ++i) os << "      " << frames[i] << '\n';
+    }
+}
+
+// Global operator new/delete hook for the allocation tracker. Only compiled
+// when ALMOND_TRACK_ALLOCATIONS is defined for the whole build (project
+// preprocessor definitions, or aengineconfig.hpp before anything else).
+#if defined(ALMOND_TRACK_ALLOCATIONS)
+
+#include <cstdint>
+#include <new>
+
+namespace
+{
+    using almondnamespace::mem::MemTag;
+    namespace memd = almondnamespace::mem::_detail;
+
+    // lets NoAllocScope know someone is actually watching the heap
+    const bool hookInstalled = (memd::g_heap_hook_installed.store(true), true);
+
+    // sits immediately before every pointer handed out
+    struct alloc_header {
+        void*       raw;
+        std::size_t size;
+        MemTag      tag;
+        bool        counted;
+    };
+
+    void* tracked_alloc(std::size_t n, std::size_t align) noexcept {
+        align = std::max(align, alignof(std::max_align_t));
+        for (;;) {
+            if (void* raw = std::malloc(n + sizeof(alloc_header) + align - 1)) {
+                const auto addr = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(alloc_header) + align - 1)
+                    & ~(static_cast<std::uintptr_t>(align) - 1);
+                auto* h = reinterpret_cast<alloc_header*>(addr) - 1;
+                h->raw = raw;
+                h->size = n;
+                h->tag = memd::t_current_tag;
+                h->counted = memd::t_hook_suppressed == 0;
+                if (h->counted) almondnamespace::mem::record_alloc(h->tag, n);
+                if (memd::t_no_alloc.depth) memd::note_heap_allocation(n, h->tag);
+                return reinterpret_cast<void*>(addr);
+            }
+            auto handler = std::get_new_handler();
+            if (!handler) return nullptr;
+            handler();
+        }
+    }
+
+    void* tracked_alloc_or_throw(std::size_t n, std::size_t align) {
+        if (void* p = tracked_alloc(n, align)) return p;
+        throw std::bad_alloc{};
+    }
+
+    void tracked_free(void* p) noexcept {
+        if (!p) return;
+        auto* h = static_cast<alloc_header*>(p) - 1;
+        if (h->counted) almondnamespace::mem::record_free(h->tag, h->size);
+        std::free(h->raw);
+    }
+}
+
+void* operator new  (std::size_t n) { return tracked_alloc_or_throw(n, 0); }
+void* operator new[](std::size_t n) { return tracked_alloc_or_throw(n, 0); }
+void* operator new  (std::size_t n, std::align_val_t a) { return tracked_alloc_or_throw(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return tracked_alloc_or_throw(n, static_cast<std::size_t>(a)); }
+void* operator new  (std::size_t n, const std::nothrow_t&) noexcept { return tracked_alloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return tracked_alloc(n, 0); }
+void* operator new  (std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return tracked_alloc(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return tracked_alloc(n, static_cast<std::size_t>(a)); }
+
+void operator delete  (void* p) noexcept { tracked_free(p); }
+void operator delete[](void* p) noexcept { tracked_free(p); }
+void operator delete  (void* p, std::size_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { tracked_free(p); }
+void operator delete  (void* p, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete  (void* p, std::size_t, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { tracked_free(p); }
+void operator delete  (void* p, const std::nothrow_t&) noexcept { tracked_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { tracked_free(p); }
+void operator delete  (void* p, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(p); }
+
+#endif // ALMOND_TRACK_ALLOCATIONS
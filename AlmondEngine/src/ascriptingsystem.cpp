@@ -121,8 +121,7 @@ bool almondnamespace::scripting::load_or_reload_script(const std::string& script
     try {
         almondnamespace::Task t = do_load_script(scriptName, scheduler);
         auto node = std::make_unique<taskgraph::Node>(std::move(t));
-        scheduler.AddNode(std::move(node));
-        scheduler.Execute();
+        scheduler.Submit(std::move(node));
         return true;
     } catch (const std::exception& e) {
         std::cerr << "[script] Scheduling exception: " << e.what() << "\n";